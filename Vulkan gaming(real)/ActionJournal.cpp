@@ -0,0 +1,94 @@
+#include "ActionJournal.h"
+
+#include <algorithm>
+#include <tuple>
+
+void ActionJournal::setDepth(std::size_t newDepth)
+{
+	depth = newDepth;
+	while (undoActions.size() > depth) undoActions.pop_front();
+	while (redoActions.size() > depth) redoActions.pop_front();
+}
+
+void ActionJournal::clear()
+{
+	undoActions.clear();
+	redoActions.clear();
+}
+
+ActionJournal::Action const* ActionJournal::record(CellState from, CellState to, uint8_t stateBefore, uint8_t stateAfter,
+	std::vector<std::pair<int64_t, int64_t>>& cells)
+{
+	if (!isEnabled() || cells.empty()) return nullptr;
+
+	std::sort(cells.begin(), cells.end(), [](auto const& left, auto const& right)
+		{
+			return std::tie(left.second, left.first) < std::tie(right.second, right.first);
+		});
+
+	Action action{ from, to, stateBefore, stateAfter, cells.size(), {} };
+	int64_t x = 0, y = 0;
+	for (auto [cellX, cellY] : cells)
+	{
+		writeVarint(action.encodedCells, encodeZigzag(cellY - y));
+		writeVarint(action.encodedCells, encodeZigzag(cellX - x));
+		x = cellX;
+		y = cellY;
+	}
+	action.encodedCells.shrink_to_fit();
+
+	append(std::move(action));
+	return &undoActions.back();
+}
+
+void ActionJournal::append(Action&& action)
+{
+	redoActions.clear();
+	pushUndo(std::move(action));
+}
+
+bool ActionJournal::fitsBoard(Action const& action, uint64_t width, uint64_t height)
+{
+	bool inside = true;
+	bool complete = forEachCell(action, [&](int64_t x, int64_t y)
+		{
+			inside = inside && x >= 0 && y >= 0 && static_cast<uint64_t>(x) < width && static_cast<uint64_t>(y) < height;
+		});
+	return complete && inside;
+}
+
+std::optional<ActionJournal::Action> ActionJournal::popUndo()
+{
+	if (undoActions.empty()) return std::nullopt;
+	auto action = std::move(undoActions.back());
+	undoActions.pop_back();
+	return action;
+}
+
+std::optional<ActionJournal::Action> ActionJournal::popRedo()
+{
+	if (redoActions.empty()) return std::nullopt;
+	auto action = std::move(redoActions.back());
+	redoActions.pop_back();
+	return action;
+}
+
+void ActionJournal::pushUndo(Action&& action)
+{
+	undoActions.push_back(std::move(action));
+	if (undoActions.size() > depth) undoActions.pop_front();
+}
+
+void ActionJournal::pushRedo(Action&& action)
+{
+	redoActions.push_back(std::move(action));
+	if (redoActions.size() > depth) redoActions.pop_front();
+}
+
+std::size_t ActionJournal::getMemoryUsage() const
+{
+	std::size_t bytes = 0;
+	for (auto const& action : undoActions) bytes += sizeof(Action) + action.encodedCells.capacity();
+	for (auto const& action : redoActions) bytes += sizeof(Action) + action.encodedCells.capacity();
+	return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gameConstants.h"
+#include "BoardGenerator.h"
+#include "helpers.h"
+
+//undo and redo history of board actions, each kept as the cells it moved from one state to another
+//cells are sorted by row and stored as zigzag varint deltas from the previous cell, about two bytes per cell of a flood fill
+//at most depth actions are kept, the oldest are dropped first
+class ActionJournal
+{
+public:
+	using CellState = BoardLayout::CellState;
+
+	//how an action reached the board, so the history can be rebuilt from a log of them
+	enum class Change : uint8_t
+	{
+		eRecorded, eUndone, eRedone
+	};
+	struct Action
+	{
+		CellState from;
+		CellState to;
+		uint8_t stateBefore;
+		uint8_t stateAfter;
+		uint64_t cellCount{};
+		std::vector<uint8_t> encodedCells;
+	};
+
+public:
+	explicit ActionJournal(std::size_t depth = JOURNAL_HISTORY_DEPTH) :depth(depth) {}
+
+	bool isEnabled() const { return depth > 0; }
+	void setDepth(std::size_t newDepth);
+	void clear();
+
+	//sorts cells in place, recording drops everything that could be redone, returns the new action or nullptr if nothing was recorded
+	Action const* record(CellState from, CellState to, uint8_t stateBefore, uint8_t stateAfter, std::vector<std::pair<int64_t, int64_t>>& cells);
+	//an already encoded action, as read back from an autosave
+	void append(Action&& action);
+
+	std::optional<Action> popUndo();
+	std::optional<Action> popRedo();
+	void pushUndo(Action&& action);
+	void pushRedo(Action&& action);
+
+	std::size_t getUndoCount() const { return undoActions.size(); }
+	std::size_t getRedoCount() const { return redoActions.size(); }
+	std::size_t getMemoryUsage() const;
+
+	//false if the encoding ends early, cells before that point have already been passed to function
+	template<class Function>
+	static bool forEachCell(Action const& action, Function&& function)
+	{
+		int64_t x = 0, y = 0;
+		std::size_t offset = 0;
+		for (uint64_t i = 0; i < action.cellCount; i++)
+		{
+			uint64_t yDelta{}, xDelta{};
+			if (!readVarint(action.encodedCells, offset, yDelta) || !readVarint(action.encodedCells, offset, xDelta)) return false;
+			y += decodeZigzag(yDelta);
+			x += decodeZigzag(xDelta);
+			function(x, y);
+		}
+		return true;
+	}
+	//every cell decodes and lies on a width by height board, for actions read back from a file
+	static bool fitsBoard(Action const& action, uint64_t width, uint64_t height);
+
+private:
+	std::size_t depth;
+	std::deque<Action> undoActions;
+	std::deque<Action> redoActions;
+};
\ No newline at end of file
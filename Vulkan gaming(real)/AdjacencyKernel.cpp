@@ -0,0 +1,162 @@
+#include "AdjacencyKernel.h"
+
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define ADJACENCY_KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+//MSVC emits any intrinsic without a matching /arch flag
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+//with explicit vector kernels around the scalar one is their reference, keep compilers from vectorising it at -O3
+#if defined(__clang__)
+#define SCALAR_FUNCTION
+#define SCALAR_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(__GNUC__)
+#define SCALAR_FUNCTION __attribute__((optimize("no-tree-vectorize")))
+#define SCALAR_LOOP
+#else
+#define SCALAR_FUNCTION
+#define SCALAR_LOOP __pragma(loop(no_vector))
+#endif
+#else
+#define SCALAR_FUNCTION
+#define SCALAR_LOOP
+#endif
+
+//the row's column sums go into sums[1..width], sums[0] and sums[width + 1] stay zero so the horizontal pass needs no edge cases
+SCALAR_FUNCTION static void sumColumnsScalar(uint8_t const* above, uint8_t const* row, uint8_t const* below, size_t begin, size_t width, uint8_t* sums)
+{
+	SCALAR_LOOP
+	for (size_t x = begin; x < width; x++)
+	{
+		sums[x + 1] = row[x] + (above ? above[x] : 0) + (below ? below[x] : 0);
+	}
+}
+
+SCALAR_FUNCTION static void sumRowsScalar(uint8_t const* sums, uint8_t const* row, size_t begin, size_t width, uint8_t* counts)
+{
+	SCALAR_LOOP
+	for (size_t x = begin; x < width; x++)
+	{
+		counts[x] = sums[x] + sums[x + 1] + sums[x + 2] - row[x];
+	}
+}
+
+#ifdef ADJACENCY_KERNEL_X86
+static void countRowSse2(uint8_t const* above, uint8_t const* row, uint8_t const* below, size_t width, uint8_t* sums, uint8_t* counts)
+{
+	size_t x = 0;
+	for (; x + 16 <= width; x += 16)
+	{
+		auto sum = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row + x));
+		if (above) sum = _mm_add_epi8(sum, _mm_loadu_si128(reinterpret_cast<__m128i const*>(above + x)));
+		if (below) sum = _mm_add_epi8(sum, _mm_loadu_si128(reinterpret_cast<__m128i const*>(below + x)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 1), sum);
+	}
+	sumColumnsScalar(above, row, below, x, width, sums);
+
+	for (x = 0; x + 16 <= width; x += 16)
+	{
+		auto left = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums + x));
+		auto centre = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums + x + 1));
+		auto right = _mm_loadu_si128(reinterpret_cast<__m128i const*>(sums + x + 2));
+		auto self = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row + x));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(counts + x), _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(left, centre), right), self));
+	}
+	sumRowsScalar(sums, row, x, width, counts);
+}
+
+TARGET_AVX2 static void countRowAvx2(uint8_t const* above, uint8_t const* row, uint8_t const* below, size_t width, uint8_t* sums, uint8_t* counts)
+{
+	size_t x = 0;
+	for (; x + 32 <= width; x += 32)
+	{
+		auto sum = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(row + x));
+		if (above) sum = _mm256_add_epi8(sum, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(above + x)));
+		if (below) sum = _mm256_add_epi8(sum, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(below + x)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + x + 1), sum);
+	}
+	sumColumnsScalar(above, row, below, x, width, sums);
+
+	for (x = 0; x + 32 <= width; x += 32)
+	{
+		auto left = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(sums + x));
+		auto centre = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(sums + x + 1));
+		auto right = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(sums + x + 2));
+		auto self = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(row + x));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(counts + x), _mm256_sub_epi8(_mm256_add_epi8(_mm256_add_epi8(left, centre), right), self));
+	}
+	sumRowsScalar(sums, row, x, width, counts);
+}
+
+static bool isAvx2Supported()
+{
+#ifdef _MSC_VER
+	int registers[4]{};
+	__cpuid(registers, 0);
+	if (registers[0] < 7) return false;
+	__cpuid(registers, 1);
+	//the OS has to save the ymm registers as well, which OSXSAVE and XCR0 report
+	bool osSavesYmm = (registers[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+	__cpuidex(registers, 7, 0);
+	return osSavesYmm && (registers[1] & (1 << 5));
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+AdjacencyKernel getBestAdjacencyKernel()
+{
+#ifdef ADJACENCY_KERNEL_X86
+	static AdjacencyKernel const bestKernel = isAvx2Supported() ? AdjacencyKernel::eAvx2 : AdjacencyKernel::eSse2;
+	return bestKernel;
+#else
+	return AdjacencyKernel::eScalar;
+#endif
+}
+
+std::string_view getAdjacencyKernelName(AdjacencyKernel kernel)
+{
+	switch (kernel)
+	{
+	case AdjacencyKernel::eSse2:
+		return "SSE2"sv;
+	case AdjacencyKernel::eAvx2:
+		return "AVX2"sv;
+	default:
+		return "scalar"sv;
+	}
+}
+
+void countAdjacentMines(uint8_t const* mines, size_t width, size_t height, uint8_t* counts, AdjacencyKernel kernel)
+{
+	std::vector<uint8_t> sums(width + 2, 0);
+	for (size_t y = 0; y < height; y++)
+	{
+		auto row = mines + y * width;
+		auto above = y > 0 ? row - width : nullptr;
+		auto below = y + 1 < height ? row + width : nullptr;
+		auto rowCounts = counts + y * width;
+		switch (kernel)
+		{
+#ifdef ADJACENCY_KERNEL_X86
+		case AdjacencyKernel::eSse2:
+			countRowSse2(above, row, below, width, sums.data(), rowCounts);
+			break;
+		case AdjacencyKernel::eAvx2:
+			countRowAvx2(above, row, below, width, sums.data(), rowCounts);
+			break;
+#endif
+		default:
+			sumColumnsScalar(above, row, below, 0, width, sums.data());
+			sumRowsScalar(sums.data(), row, 0, width, rowCounts);
+			break;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string_view>
+
+#include "gameConstants.h"
+
+enum class AdjacencyKernel
+{
+	eScalar, eSse2, eAvx2
+};
+
+//widest kernel the CPU running the program supports, detected once
+AdjacencyKernel getBestAdjacencyKernel();
+std::string_view getAdjacencyKernelName(AdjacencyKernel kernel);
+
+//mines holds 0 or 1 per cell row major, counts receives how many of each cell's 8 neighbours are mines
+//computed as a 3x3 box sum minus the centre, cells outside the grid count as clear
+void countAdjacentMines(uint8_t const* mines, size_t width, size_t height, uint8_t* counts, AdjacencyKernel kernel = getBestAdjacencyKernel());
\ No newline at end of file
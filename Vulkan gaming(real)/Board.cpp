@@ -0,0 +1,348 @@
+#include "Board.h"
+
+#include <format>
+#include <numeric>
+
+#include "GameSnapshot.h"
+#include "errors.h"
+
+Board::Board(size_t width, size_t height, Mode mode, uint64_t infiniteSeed)
+	:mode{ mode }, width{ width }, height{ height }
+{
+	if (mode == Mode::eInfinite)
+	{
+		chunkStore = std::make_unique<ChunkStore>(INFINITE_CHUNK_STORE_FILE, infiniteSeed, INFINITE_MINE_DENSITY, INFINITE_CHUNK_MEMORY_BUDGET);
+	}
+}
+
+void Board::applyLayout(BoardLayout&& layout)
+{
+	cells = std::move(layout.cells);
+	snapshot.reset();
+	pendingChunks.clear();
+	pendingChunkCount = 0;
+	snapshotCorrupt = false;
+	mineCount = layout.mineCount;
+	coveredCellCount = cells.getCellCount() - mineCount;
+	markedCellCount = 0;
+	startCell = layout.startCell;
+	journal.clear();
+	changeState(State::ePreparing);
+}
+
+void Board::resetInfinite(uint64_t seed)
+{
+	chunkStore->reset(seed);
+	markedCellCount = 0;
+	journal.clear();
+	changeState(State::ePreparing);
+}
+
+void Board::loadSnapshot(std::shared_ptr<GameSnapshot const> newSnapshot)
+{
+	snapshot = std::move(newSnapshot);
+	cells = ChunkedGrid<Cell>(width, height);
+	pendingChunkCount = cells.getChunkCount();
+	pendingChunks.assign(pendingChunkCount, true);
+	snapshotCorrupt = false;
+	mineCount = snapshot->getMineCount();
+	auto const& progress = snapshot->getBaseProgress();
+	coveredCellCount = progress.coveredCellCount;
+	markedCellCount = progress.markedCellCount;
+	currentState = static_cast<State>(progress.state);
+	startCell.reset();
+	journal.clear();
+
+	//keep a reference, the last replayed action can decode the final chunk and release the snapshot
+	auto source = snapshot;
+	for (auto const& record : source->getRecords())
+	{
+		switch (record.change)
+		{
+		case ActionJournal::Change::eRecorded:
+			replayAction(record.action, false);
+			journal.append(ActionJournal::Action{ record.action });
+			break;
+		case ActionJournal::Change::eUndone:
+			replayAction(record.action, true);
+			if (auto action = journal.popUndo()) journal.pushRedo(std::move(*action));
+			break;
+		case ActionJournal::Change::eRedone:
+			replayAction(record.action, false);
+			if (auto action = journal.popRedo()) journal.pushUndo(std::move(*action));
+			break;
+		}
+	}
+	changeState(currentState);
+}
+
+void Board::decodeAllChunks(ThreadPool* threadPool)
+{
+	std::vector<size_t> chunks(pendingChunks.size());
+	std::iota(chunks.begin(), chunks.end(), size_t{0});
+	decodeChunks(chunks, threadPool);
+}
+
+void Board::decodeChunks(std::vector<size_t> const& chunks, ThreadPool* threadPool)
+{
+	if (pendingChunkCount == 0) return;
+
+	std::vector<size_t> undecoded;
+	for (auto chunk : chunks)
+	{
+		if (pendingChunks[chunk]) undecoded.push_back(chunk);
+	}
+
+	//chunks decode into disjoint cells, only the bookkeeping afterwards has to stay on this thread
+	std::vector<uint8_t> valid(undecoded.size());
+	auto decode = [&](size_t rangeBegin, size_t rangeEnd)
+	{
+		for (auto i = rangeBegin; i < rangeEnd; i++)
+		{
+			valid[i] = snapshot->decodeChunk(undecoded[i], cells.getChunkData(undecoded[i]));
+		}
+	};
+	if (threadPool) parallelFor(*threadPool, 0, undecoded.size(), 1, decode);
+	else decode(0, undecoded.size());
+
+	for (size_t i = 0; i < undecoded.size(); i++)
+	{
+		finishChunkDecode(undecoded[i], valid[i]);
+	}
+}
+
+void Board::openStartCell()
+{
+	if (!startCell) return;
+
+	uncoverCells(static_cast<int64_t>(startCell->first), static_cast<int64_t>(startCell->second));
+	changedCells.clear();
+	changeState(State::ePreparing);
+}
+
+void Board::pressCell(int64_t xIndex, int64_t yIndex)
+{
+	auto stateBefore = currentState;
+	//an infinite board has no fixed opening, the first pressed cell wherever the view is gets the safe area
+	if (mode == Mode::eInfinite && currentState == State::ePreparing) chunkStore->setSafeCell(xIndex, yIndex);
+	uncoverCells(xIndex, yIndex);
+	recordAction(CellState::eCovered, CellState::eUncovered, stateBefore);
+}
+
+void Board::uncoverCells(int64_t xIndex, int64_t yIndex)
+{
+	//explicit stack instead of recursion, openings on large boards are far deeper than the call stack
+	std::vector<std::pair<int64_t, int64_t>> pendingCells{ { xIndex, yIndex } };
+	while (!pendingCells.empty())
+	{
+		auto [xPressed, yPressed] = pendingCells.back();
+		pendingCells.pop_back();
+
+		auto& pressedCell = getCellAtIndex(xPressed, yPressed);
+		if (pressedCell.state != CellState::eCovered) continue;
+
+		//read before touching neighbours, which may evict the chunk of an infinite board
+		pressedCell.state = CellState::eUncovered;
+		bool mined = pressedCell.mined;
+		uint8_t glyph = getCellGlyph(pressedCell);
+
+		if (mined) changeState(State::eLost);
+		else if (glyph == ' ')
+		{
+			for (auto&& [xOffset, yOffset] : ADJACENCY_OFFSETS)
+			{
+				int64_t xAdjacent = xPressed + xOffset;
+				int64_t yAdjacent = yPressed + yOffset;
+				if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
+				{
+					pendingCells.emplace_back(xAdjacent, yAdjacent);
+				}
+			}
+		}
+
+		if (!mined)
+		{
+			if (mode == Mode::eBounded) coveredCellCount--;
+			if (mode == Mode::eBounded && coveredCellCount == 0) changeState(State::eWon);
+			else if (currentState == State::ePreparing) changeState(State::ePlaying);
+		}
+
+		if (journal.isEnabled()) changedCells.emplace_back(xPressed, yPressed);
+		notifyCell(xPressed, yPressed, glyph);
+	}
+}
+
+void Board::markCell(int64_t xIndex, int64_t yIndex)
+{
+	getCellAtIndex(xIndex, yIndex).state = CellState::eMarked;
+	markedCellCount++;
+	notifyCell(xIndex, yIndex, '!');
+	if (journal.isEnabled()) changedCells.emplace_back(xIndex, yIndex);
+	recordAction(CellState::eCovered, CellState::eMarked, currentState);
+}
+
+void Board::unmarkCell(int64_t xIndex, int64_t yIndex)
+{
+	getCellAtIndex(xIndex, yIndex).state = CellState::eCovered;
+	markedCellCount--;
+	notifyCell(xIndex, yIndex, '#');
+	if (journal.isEnabled()) changedCells.emplace_back(xIndex, yIndex);
+	recordAction(CellState::eMarked, CellState::eCovered, currentState);
+}
+
+bool Board::chordCell(int64_t xIndex, int64_t yIndex)
+{
+	uint8_t adjacentMarks = 0;
+	for (auto&& [xOffset, yOffset] : ADJACENCY_OFFSETS)
+	{
+		int64_t xAdjacent = xIndex + xOffset;
+		int64_t yAdjacent = yIndex + yOffset;
+		if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eMarked) adjacentMarks++;
+	}
+	if (adjacentMarks != getCellAtIndex(xIndex, yIndex).adjacentMines) return false;
+
+	auto stateBefore = currentState;
+	for (auto&& [xOffset, yOffset] : ADJACENCY_OFFSETS)
+	{
+		int64_t xAdjacent = xIndex + xOffset;
+		int64_t yAdjacent = yIndex + yOffset;
+		if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
+		{
+			uncoverCells(xAdjacent, yAdjacent);
+		}
+	}
+	recordAction(CellState::eCovered, CellState::eUncovered, stateBefore);
+	return true;
+}
+
+bool Board::undo()
+{
+	auto action = journal.popUndo();
+	if (!action) return false;
+
+	replayAction(*action, true);
+	notifyAction(*action, ActionJournal::Change::eUndone);
+	journal.pushRedo(std::move(*action));
+	return true;
+}
+
+bool Board::redo()
+{
+	auto action = journal.popRedo();
+	if (!action) return false;
+
+	replayAction(*action, false);
+	notifyAction(*action, ActionJournal::Change::eRedone);
+	journal.pushUndo(std::move(*action));
+	return true;
+}
+
+Board::Cell& Board::getCellAtIndex(int64_t xIndex, int64_t yIndex)
+{
+	if (mode == Mode::eInfinite) return chunkStore->getCell(xIndex, yIndex);
+	if (pendingChunkCount > 0) decodeChunk(cells.getChunkIndex(xIndex, yIndex));
+	return cells(xIndex, yIndex);
+}
+
+Board::Cell const* Board::findCell(int64_t xIndex, int64_t yIndex)
+{
+	if (mode == Mode::eInfinite) return chunkStore->findCell(xIndex, yIndex);
+	if (pendingChunkCount > 0) decodeChunk(cells.getChunkIndex(xIndex, yIndex));
+	return &cells(xIndex, yIndex);
+}
+
+bool Board::isIndexValid(int64_t xIndex, int64_t yIndex) const
+{
+	if (mode == Mode::eInfinite) return true;
+	return xIndex >= 0 && xIndex < (int64_t)width && yIndex >= 0 && yIndex < (int64_t)height;
+}
+
+SolverInput Board::getSolverInput(std::pair<int64_t, int64_t> origin)
+{
+	SolverInput input{ width, height, std::vector<int8_t>(width * height, SolverInput::COVERED), {}, INFINITE_MINE_DENSITY, mode == Mode::eInfinite };
+	if (mode == Mode::eBounded) input.mineCount = mineCount;
+	for (size_t i = 0; i < height; i++)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			auto cell = findCell(origin.first + static_cast<int64_t>(j), origin.second + static_cast<int64_t>(i));
+			if (!cell) continue;
+
+			if (cell->state == CellState::eMarked) input.cells[i * width + j] = SolverInput::MARKED;
+			else if (cell->state == CellState::eUncovered && !cell->mined) input.cells[i * width + j] = static_cast<int8_t>(cell->adjacentMines);
+		}
+	}
+	return input;
+}
+
+uint8_t Board::getCellGlyph(Cell const& cell)
+{
+	switch (cell.state)
+	{
+	case CellState::eMarked:
+		return '!';
+	case CellState::eUncovered:
+		if (cell.mined) return 'X';
+		return cell.adjacentMines == 0 ? ' ' : '0' + cell.adjacentMines;
+	default:
+		return '#';
+	}
+}
+
+void Board::recordAction(CellState from, CellState to, State stateBefore)
+{
+	if (auto action = journal.record(from, to, static_cast<uint8_t>(stateBefore), static_cast<uint8_t>(currentState), changedCells))
+	{
+		notifyAction(*action, ActionJournal::Change::eRecorded);
+	}
+	changedCells.clear();
+}
+
+void Board::replayAction(ActionJournal::Action const& action, bool undoing)
+{
+	auto target = undoing ? action.from : action.to;
+	ActionJournal::forEachCell(action, [&](int64_t xIndex, int64_t yIndex)
+		{
+			auto& cell = getCellAtIndex(xIndex, yIndex);
+			if (cell.state == CellState::eMarked) markedCellCount--;
+			if (target == CellState::eMarked) markedCellCount++;
+			if (mode == Mode::eBounded && !cell.mined)
+			{
+				if (cell.state == CellState::eUncovered) coveredCellCount++;
+				if (target == CellState::eUncovered) coveredCellCount--;
+			}
+			cell.state = target;
+			notifyCell(xIndex, yIndex, getCellGlyph(cell));
+		});
+
+	auto state = static_cast<State>(undoing ? action.stateBefore : action.stateAfter);
+	if (state != currentState) changeState(state);
+}
+
+void Board::decodeChunk(size_t chunk)
+{
+	if (!pendingChunks[chunk]) return;
+
+	finishChunkDecode(chunk, snapshot->decodeChunk(chunk, cells.getChunkData(chunk)));
+}
+
+void Board::finishChunkDecode(size_t chunk, bool valid)
+{
+	pendingChunks[chunk] = false;
+	if (!valid)
+	{
+		errorLog << std::format("snapshot chunk {} failed its checksum, the board is discarded\n"sv, chunk);
+		snapshotCorrupt = true;
+	}
+	if (--pendingChunkCount == 0)
+	{
+		pendingChunks.clear();
+		snapshot.reset();
+	}
+}
+
+void Board::changeState(State newState)
+{
+	currentState = newState;
+	if (observer) observer->onStateChanged(newState);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gameConstants.h"
+#include "ActionJournal.h"
+#include "BoardGenerator.h"
+#include "ChunkStore.h"
+#include "Solver.h"
+
+class GameSnapshot;
+
+//rules of a game with no presentation attached, so it can be played programmatically on any thread
+//what a cell shows is reported to the observer as the glyph drawn for it, boards without an observer run headless
+class Board
+{
+public:
+	using CellState = BoardLayout::CellState;
+	using Cell = BoardLayout::Cell;
+
+	enum class State : size_t
+	{
+		ePlaying, eLost, eWon, ePreparing
+	};
+	//infinite boards have no edges, width and height then give the window the solver input covers and mine counts are unused
+	//openings stay finite only while INFINITE_MINE_DENSITY keeps mine free neighbourhoods below the percolation threshold, roughly above 0.1
+	enum class Mode
+	{
+		eBounded, eInfinite
+	};
+
+	class Observer
+	{
+	public:
+		virtual ~Observer() = default;
+		virtual void onCellChanged(int64_t xIndex, int64_t yIndex, uint8_t glyph) = 0;
+		virtual void onStateChanged(State newState) = 0;
+		//after an action is recorded, undone or redone
+		virtual void onActionApplied(ActionJournal::Action const&, ActionJournal::Change) {}
+	};
+
+	static constexpr std::array<std::pair<int64_t, int64_t>, 8> ADJACENCY_OFFSETS{ {
+		{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1} } };
+
+public:
+	Board(size_t width, size_t height, Mode mode = Mode::eBounded, uint64_t infiniteSeed = 0);
+
+	void setObserver(Observer* newObserver) { observer = newObserver; }
+
+	void applyLayout(BoardLayout&& layout);
+	void resetInfinite(uint64_t seed);
+	//cells of a snapshot are decoded a chunk at a time on first access, so opening a huge board only reads the pages that get looked at
+	//the autosave log is replayed on top and rebuilds the undo history
+	void loadSnapshot(std::shared_ptr<GameSnapshot const> newSnapshot);
+	//getCells reads storage directly and only sees decoded chunks
+	void decodeAllChunks(ThreadPool* threadPool = nullptr);
+	//decodes the given snapshot chunks that are still pending, spread over threadPool when one is given
+	void decodeChunks(std::vector<size_t> const& chunks, ThreadPool* threadPool = nullptr);
+	bool isChunkDecoded(size_t chunk) const { return pendingChunks.empty() || !pendingChunks[chunk]; }
+	//a chunk of the snapshot failed its checksum when it was decoded, the game no longer matches the save and has to be replaced
+	bool isSnapshotCorrupt() const { return snapshotCorrupt; }
+	//uncovering the opening of a no-guess layout is not the player's first move, the board stays in preparation
+	void openStartCell();
+
+	//every press, mark, unmark and chord is one journal action
+	void pressCell(int64_t xIndex, int64_t yIndex);
+	void markCell(int64_t xIndex, int64_t yIndex);
+	void unmarkCell(int64_t xIndex, int64_t yIndex);
+	//presses the covered neighbours of an uncovered cell once enough of them are marked, returns whether it did
+	bool chordCell(int64_t xIndex, int64_t yIndex);
+
+	//only the cells of the action are touched, the observer sees them change back like any other cell
+	bool undo();
+	bool redo();
+	//a depth of 0 turns recording off, as the batch simulation wants
+	void setJournalDepth(std::size_t depth) { journal.setDepth(depth); }
+	ActionJournal const& getJournal() const { return journal; }
+
+	Cell& getCellAtIndex(int64_t xIndex, int64_t yIndex);
+	//nullptr for cells of an infinite board that were never touched, without creating their chunk
+	Cell const* findCell(int64_t xIndex, int64_t yIndex);
+	bool isIndexValid(int64_t xIndex, int64_t yIndex) const;
+	//width by height cells starting at origin, which is always zero on bounded boards
+	SolverInput getSolverInput(std::pair<int64_t, int64_t> origin = {});
+
+	static uint8_t getCellGlyph(Cell const& cell);
+
+	State getCurrentState() const { return currentState; }
+	Mode getMode() const { return mode; }
+	size_t getWidth() const { return width; }
+	size_t getHeight() const { return height; }
+	size_t getMineCount() const { return mineCount; }
+	size_t getMarkedCellCount() const { return markedCellCount; }
+	size_t getCoveredCellCount() const { return coveredCellCount; }
+	size_t getCellCount() const { return width * height; }
+	ChunkedGrid<Cell> const& getCells() const { return cells; }
+
+private:
+	void uncoverCells(int64_t xIndex, int64_t yIndex);
+	void recordAction(CellState from, CellState to, State stateBefore);
+	void replayAction(ActionJournal::Action const& action, bool undoing);
+	void changeState(State newState);
+	void decodeChunk(size_t chunk);
+	void finishChunkDecode(size_t chunk, bool valid);
+	void notifyAction(ActionJournal::Action const& action, ActionJournal::Change change)
+	{
+		if (observer) observer->onActionApplied(action, change);
+	}
+	void notifyCell(int64_t xIndex, int64_t yIndex, uint8_t glyph)
+	{
+		if (observer) observer->onCellChanged(xIndex, yIndex, glyph);
+	}
+
+	Mode mode;
+	size_t width;
+	size_t height;
+	Observer* observer = nullptr;
+
+	ChunkedGrid<Cell> cells;
+	std::unique_ptr<ChunkStore> chunkStore;
+	std::optional<std::pair<size_t, size_t>> startCell;
+	ActionJournal journal;
+	std::vector<std::pair<int64_t, int64_t>> changedCells;
+	std::shared_ptr<GameSnapshot const> snapshot;
+	std::vector<bool> pendingChunks;
+	size_t pendingChunkCount{};
+	bool snapshotCorrupt = false;
+
+	size_t mineCount{};
+	size_t coveredCellCount{};
+	size_t markedCellCount{};
+	State currentState = State::ePreparing;
+};
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "BoardAnalysis.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+static constexpr uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+
+struct Run
+{
+	uint32_t start;
+	uint32_t end;
+	uint32_t label;
+};
+
+struct Components
+{
+	uint64_t count{};
+	uint64_t largest{};
+};
+
+//runs of set bits in a row found from the words' run boundaries, bits past the row's width are always clear
+static void findRuns(uint64_t const* row, size_t wordCount, std::vector<Run>& runs)
+{
+	runs.clear();
+	uint32_t openStart = 0;
+	for (size_t i = 0; i < wordCount; i++)
+	{
+		auto word = row[i];
+		if (word == 0) continue;
+		auto starts = word & ~((word << 1) | (i > 0 ? row[i - 1] >> 63 : 0));
+		auto ends = word & ~((word >> 1) | (i + 1 < wordCount ? row[i + 1] << 63 : 0));
+
+		//within a word starts and ends alternate, a single cell run has both on the same bit
+		while (starts != 0 || ends != 0)
+		{
+			auto nextStart = starts != 0 ? std::countr_zero(starts) : 64;
+			auto nextEnd = ends != 0 ? std::countr_zero(ends) : 64;
+			if (nextStart <= nextEnd)
+			{
+				openStart = static_cast<uint32_t>(i * 64 + nextStart);
+				starts &= starts - 1;
+			}
+			else
+			{
+				runs.push_back({ openStart, static_cast<uint32_t>(i * 64 + nextEnd + 1), NO_LABEL });
+				ends &= ends - 1;
+			}
+		}
+	}
+}
+
+//a cell's bit is set when it or either horizontal neighbour is set in source
+static void dilateRow(uint64_t const* source, uint64_t* target, size_t wordCount)
+{
+	for (size_t i = 0; i < wordCount; i++)
+	{
+		uint64_t fromLeft = (source[i] << 1) | (i > 0 ? source[i - 1] >> 63 : 0);
+		uint64_t fromRight = (source[i] >> 1) | (i + 1 < wordCount ? source[i + 1] << 63 : 0);
+		target[i] = source[i] | fromLeft | fromRight;
+	}
+}
+
+//the 3x3 neighbourhood of every cell, rows outside the bitmap count as clear
+static std::vector<uint64_t> dilate(std::vector<uint64_t> const& bits, size_t height, size_t wordsPerRow)
+{
+	std::vector<uint64_t> vertical(bits.size());
+	for (size_t y = 0; y < height; y++)
+	{
+		for (size_t i = 0; i < wordsPerRow; i++)
+		{
+			auto word = bits[y * wordsPerRow + i];
+			if (y > 0) word |= bits[(y - 1) * wordsPerRow + i];
+			if (y + 1 < height) word |= bits[(y + 1) * wordsPerRow + i];
+			vertical[y * wordsPerRow + i] = word;
+		}
+	}
+	std::vector<uint64_t> result(bits.size());
+	for (size_t y = 0; y < height; y++)
+	{
+		dilateRow(vertical.data() + y * wordsPerRow, result.data() + y * wordsPerRow, wordsPerRow);
+	}
+	return result;
+}
+
+static uint32_t findRoot(std::vector<uint32_t>& parents, uint32_t label)
+{
+	while (parents[label] != label)
+	{
+		parents[label] = parents[parents[label]];
+		label = parents[label];
+	}
+	return label;
+}
+
+//8-connected components of the set bits, every run of the current row is joined with the runs of the previous row it touches
+static Components labelComponents(std::vector<uint64_t> const& bits, size_t height, size_t wordsPerRow)
+{
+	std::vector<uint32_t> parents;
+	std::vector<uint64_t> sizes;
+	std::vector<Run> previousRuns, currentRuns;
+	for (size_t y = 0; y < height; y++)
+	{
+		findRuns(bits.data() + y * wordsPerRow, wordsPerRow, currentRuns);
+		size_t previous = 0;
+		for (auto& run : currentRuns)
+		{
+			//runs touch diagonally too, so the previous row's runs may end one cell before start or begin one cell after end
+			//the first touching run lends its root to this one, further ones are merged into the lower of the two roots
+			while (previous < previousRuns.size() && previousRuns[previous].end < run.start) previous++;
+			for (auto touching = previous; touching < previousRuns.size() && previousRuns[touching].start <= run.end; touching++)
+			{
+				auto root = findRoot(parents, previousRuns[touching].label);
+				if (run.label == NO_LABEL || root == run.label)
+				{
+					run.label = root;
+					continue;
+				}
+				auto [kept, merged] = std::minmax(root, run.label);
+				parents[merged] = kept;
+				sizes[kept] += sizes[merged];
+				run.label = kept;
+			}
+			if (run.label == NO_LABEL)
+			{
+				run.label = static_cast<uint32_t>(parents.size());
+				parents.push_back(run.label);
+				sizes.push_back(0);
+			}
+			sizes[run.label] += run.end - run.start;
+		}
+		std::swap(previousRuns, currentRuns);
+	}
+
+	Components components;
+	for (uint32_t label = 0; label < parents.size(); label++)
+	{
+		if (parents[label] != label) continue;
+		components.count++;
+		components.largest = std::max(components.largest, sizes[label]);
+	}
+	return components;
+}
+
+static uint64_t countBits(std::vector<uint64_t> const& bits)
+{
+	uint64_t count = 0;
+	for (auto word : bits) count += std::popcount(word);
+	return count;
+}
+
+MineBitmap::MineBitmap(size_t width, size_t height)
+	:width(width), height(height), wordsPerRow((width + 63) / 64), words(wordsPerRow * height, 0)
+{}
+
+MineBitmap::MineBitmap(BoardLayout const& layout)
+	:MineBitmap(layout.cells.getWidth(), layout.cells.getHeight())
+{
+	for (size_t y = 0; y < height; y++)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			if (layout.cells(x, y).mined) set(x, y);
+		}
+	}
+}
+
+BoardMetrics analyzeBoard(MineBitmap const& mines)
+{
+	auto width = mines.getWidth();
+	auto height = mines.getHeight();
+	auto wordsPerRow = mines.getWordsPerRow();
+	std::vector<uint64_t> mineBits(mines.getRow(0), mines.getRow(0) + wordsPerRow * height);
+
+	std::vector<uint64_t> validBits(wordsPerRow);
+	for (size_t i = 0; i < wordsPerRow; i++)
+	{
+		auto usedBits = std::min<size_t>(width - i * 64, 64);
+		validBits[i] = usedBits == 64 ? ~uint64_t(0) : (uint64_t(1) << usedBits) - 1;
+	}
+
+	//zeros have no mine in their 3x3, numbers next to a zero are uncovered by its opening and the remaining numbers need a click each
+	auto nearMines = dilate(mineBits, height, wordsPerRow);
+	std::vector<uint64_t> zeroBits(mineBits.size());
+	for (size_t i = 0; i < zeroBits.size(); i++) zeroBits[i] = ~nearMines[i] & validBits[i % wordsPerRow];
+	auto nearZeros = dilate(zeroBits, height, wordsPerRow);
+
+	std::vector<uint64_t> isolatedBits(mineBits.size());
+	uint64_t borderCells = 0;
+	for (size_t i = 0; i < isolatedBits.size(); i++)
+	{
+		auto numbers = ~mineBits[i] & ~zeroBits[i] & validBits[i % wordsPerRow];
+		isolatedBits[i] = numbers & ~nearZeros[i];
+		borderCells += std::popcount(numbers & nearZeros[i]);
+	}
+
+	auto openings = labelComponents(zeroBits, height, wordsPerRow);
+	auto islands = labelComponents(isolatedBits, height, wordsPerRow);
+
+	BoardMetrics metrics;
+	metrics.openings = openings.count;
+	metrics.largestOpening = openings.largest;
+	metrics.islands = islands.count;
+	metrics.isolatedCells = countBits(isolatedBits);
+	metrics.bbbv = metrics.openings + metrics.isolatedCells;
+	metrics.openingCells = countBits(zeroBits) + borderCells;
+	metrics.mines = countBits(mineBits);
+	return metrics;
+}
+
+BoardMetrics analyzeBoard(BoardLayout const& layout)
+{
+	return analyzeBoard(MineBitmap(layout));
+}
\ No newline at end of file
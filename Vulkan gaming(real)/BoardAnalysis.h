@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "gameConstants.h"
+#include "BoardGenerator.h"
+
+//one bit per cell, rows padded to whole words and the padding bits always clear
+class MineBitmap
+{
+public:
+	MineBitmap() = default;
+	MineBitmap(size_t width, size_t height);
+	explicit MineBitmap(BoardLayout const& layout);
+
+	void set(size_t x, size_t y) { words[y * wordsPerRow + x / 64] |= uint64_t(1) << (x % 64); }
+	bool get(size_t x, size_t y) const { return (words[y * wordsPerRow + x / 64] >> (x % 64)) & 1; }
+
+	size_t getWidth() const { return width; }
+	size_t getHeight() const { return height; }
+	size_t getWordsPerRow() const { return wordsPerRow; }
+	uint64_t const* getRow(size_t y) const { return words.data() + y * wordsPerRow; }
+
+private:
+	size_t width{};
+	size_t height{};
+	size_t wordsPerRow{};
+	std::vector<uint64_t> words;
+};
+
+struct BoardMetrics
+{
+	//fewest clicks that clear the board, one per opening and one per number not on the edge of an opening
+	uint64_t bbbv{};
+	uint64_t openings{};
+	//8-connected groups of the numbers no opening reaches
+	uint64_t islands{};
+	uint64_t isolatedCells{};
+	//zeros plus the numbers on their edges, everything opening clicks uncover
+	uint64_t openingCells{};
+	uint64_t largestOpening{};
+	uint64_t mines{};
+};
+
+//whole rows at a time on the bitmap, zero regions are labelled in a single pass of union-find over runs of set bits
+BoardMetrics analyzeBoard(MineBitmap const& mines);
+BoardMetrics analyzeBoard(BoardLayout const& layout);
\ No newline at end of file
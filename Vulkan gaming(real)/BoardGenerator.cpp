@@ -0,0 +1,146 @@
+#include "BoardGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "AdjacencyKernel.h"
+
+BoardLayout generateBoardLayout(size_t width, size_t height, size_t mineCount, Random random, std::optional<std::pair<size_t, size_t>> safeCell)
+{
+	BoardLayout layout;
+	layout.cells = ChunkedGrid<BoardLayout::Cell>(width, height);
+	layout.startCell = safeCell;
+
+	auto isSafe = [&](size_t x, size_t y)
+	{
+		return safeCell && x + 1 >= safeCell->first && x <= safeCell->first + 1 && y + 1 >= safeCell->second && y <= safeCell->second + 1;
+	};
+	size_t safeCellCount = 1;
+	if (safeCell)
+	{
+		safeCellCount = (std::min(safeCell->first + 1, width - 1) - (safeCell->first > 0 ? safeCell->first - 1 : 0) + 1) *
+			(std::min(safeCell->second + 1, height - 1) - (safeCell->second > 0 ? safeCell->second - 1 : 0) + 1);
+	}
+	layout.mineCount = std::min(mineCount, layout.cells.getCellCount() - safeCellCount);
+
+	//shuffle a row major byte grid, which is what the adjacency kernel reads, and only then fill the chunked cells
+	std::vector<uint8_t> mines(width * height, 0);
+	std::fill_n(mines.begin(), layout.mineCount, uint8_t(1));
+	for (size_t i = mines.size() - 1; i > 0; i--)
+	{
+		std::swap(mines[i], mines[random.nextBelow(i + 1)]);
+	}
+
+	//mines that landed around the safe cell move to random free cells outside of it
+	if (safeCell)
+	{
+		for (size_t y = safeCell->second > 0 ? safeCell->second - 1 : 0; y <= std::min(safeCell->second + 1, height - 1); y++)
+		{
+			for (size_t x = safeCell->first > 0 ? safeCell->first - 1 : 0; x <= std::min(safeCell->first + 1, width - 1); x++)
+			{
+				if (!mines[y * width + x]) continue;
+
+				size_t target{};
+				do target = random.nextBelow(mines.size());
+				while (mines[target] || isSafe(target % width, target / width));
+				mines[target] = 1;
+				mines[y * width + x] = 0;
+			}
+		}
+	}
+
+	std::vector<uint8_t> adjacentMines(mines.size());
+	countAdjacentMines(mines.data(), width, height, adjacentMines.data());
+	for (size_t y = 0; y < height; y++)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			auto& cell = layout.cells(x, y);
+			cell.mined = mines[y * width + x] != 0;
+			cell.adjacentMines = adjacentMines[y * width + x];
+		}
+	}
+
+	return layout;
+}
+
+BoardLayout generateNoGuessLayout(size_t width, size_t height, size_t mineCount, Random random, std::pair<size_t, size_t> startCell,
+	std::stop_token stopToken, std::size_t threadCount)
+{
+	auto trialSeed = random();
+
+	//trials are handed out in increasing order, so once one succeeds only the lower ones still running can beat it
+	static constexpr uint64_t NO_TRIAL = std::numeric_limits<uint64_t>::max();
+	std::atomic<uint64_t> nextTrial{ 0 };
+	std::atomic<uint64_t> bestTrial{ NO_TRIAL };
+	{
+		std::vector<std::jthread> workers;
+		for (std::size_t i = 0; i < std::max<std::size_t>(threadCount, 1); i++)
+		{
+			workers.emplace_back([&]()
+				{
+					while (!stopToken.stop_requested())
+					{
+						auto trial = nextTrial.fetch_add(1, std::memory_order_relaxed);
+						if (trial >= NO_GUESS_MAX_TRIALS || trial > bestTrial.load(std::memory_order_relaxed)) return;
+
+						auto layout = generateBoardLayout(width, height, mineCount, Random(trialSeed, trial), startCell);
+						if (!isSolvableWithoutGuessing(layout, width, height, startCell)) continue;
+
+						auto best = bestTrial.load(std::memory_order_relaxed);
+						while (trial < best && !bestTrial.compare_exchange_weak(best, trial, std::memory_order_relaxed));
+					}
+				});
+		}
+	}
+
+	if (bestTrial == NO_TRIAL) return generateBoardLayout(width, height, mineCount, Random(trialSeed, 0), startCell);
+
+	auto layout = generateBoardLayout(width, height, mineCount, Random(trialSeed, bestTrial), startCell);
+	layout.noGuess = true;
+	return layout;
+}
+
+bool isSolvableWithoutGuessing(BoardLayout const& layout, size_t width, size_t height, std::pair<size_t, size_t> startCell)
+{
+	SolverInput input{ width, height, std::vector<int8_t>(width * height, SolverInput::COVERED), layout.mineCount };
+	auto safeCellCount = width * height - layout.mineCount;
+
+	auto revealedCount = revealLayoutCells(layout, input, startCell.first, startCell.second);
+	while (revealedCount < safeCellCount)
+	{
+		auto result = Solver::solveWithRules(input);
+		if (result.safeCells.empty()) return false;
+
+		for (auto cell : result.safeCells)
+		{
+			revealedCount += revealLayoutCells(layout, input, cell % width, cell / width);
+		}
+	}
+	return true;
+}
+
+std::size_t revealLayoutCells(BoardLayout const& layout, SolverInput& input, std::size_t x, std::size_t y)
+{
+	std::size_t revealedCount = 0;
+	std::vector<std::pair<std::size_t, std::size_t>> pendingCells{ {x, y} };
+	while (!pendingCells.empty())
+	{
+		auto [cellX, cellY] = pendingCells.back();
+		pendingCells.pop_back();
+		auto& seen = input.cells[cellY * input.width + cellX];
+		if (seen >= 0) continue;
+
+		seen = static_cast<int8_t>(layout.cells(cellX, cellY).adjacentMines);
+		revealedCount++;
+		if (seen != 0) continue;
+		for (std::size_t adjacentY = cellY > 0 ? cellY - 1 : 0; adjacentY <= std::min(cellY + 1, input.height - 1); adjacentY++)
+		{
+			for (std::size_t adjacentX = cellX > 0 ? cellX - 1 : 0; adjacentX <= std::min(cellX + 1, input.width - 1); adjacentX++)
+			{
+				pendingCells.emplace_back(adjacentX, adjacentY);
+			}
+		}
+	}
+	return revealedCount;
+}
\ No newline at end of file
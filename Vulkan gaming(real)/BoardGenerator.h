@@ -0,0 +1,45 @@
+#pragma once
+
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "gameConstants.h"
+#include "ChunkedGrid.h"
+#include "Random.h"
+#include "Solver.h"
+
+//mine placement of a board together with the precomputed number of mines around every cell
+struct BoardLayout
+{
+	enum class CellState : uint8_t
+	{
+		eCovered, eUncovered, eMarked
+	};
+	struct Cell
+	{
+		bool mined = false;
+		uint8_t adjacentMines = 0;
+		CellState state = CellState::eCovered;
+	};
+
+	size_t mineCount{};
+	ChunkedGrid<Cell> cells;
+	//zero cell the board is meant to be opened from, noGuess tells whether the rules solver clears the board from there
+	std::optional<std::pair<size_t, size_t>> startCell;
+	bool noGuess = false;
+};
+
+//pure function of its arguments so it can run on any thread, the 3x3 block around safeCell never receives a mine
+BoardLayout generateBoardLayout(size_t width, size_t height, size_t mineCount, Random random, std::optional<std::pair<size_t, size_t>> safeCell = {});
+
+//tries candidate boards on threadCount threads until one is cleared from startCell by the rules solver alone
+//trial n uses stream n of a seed drawn from random and the lowest succeeding trial wins, so the board depends only on the arguments, not on thread timing
+//after NO_GUESS_MAX_TRIALS or once stopToken is triggered it settles for a plain layout that still opens on startCell
+BoardLayout generateNoGuessLayout(size_t width, size_t height, size_t mineCount, Random random, std::pair<size_t, size_t> startCell,
+	std::stop_token stopToken = {}, std::size_t threadCount = std::thread::hardware_concurrency());
+
+bool isSolvableWithoutGuessing(BoardLayout const& layout, size_t width, size_t height, std::pair<size_t, size_t> startCell);
+//opens a cell of layout in the solver view, flooding through zeros, and returns how many cells were newly opened
+std::size_t revealLayoutCells(BoardLayout const& layout, SolverInput& input, std::size_t x, std::size_t y);
\ No newline at end of file
@@ -1,29 +1,32 @@
 #pragma once
 
 #include "constants.h"
+#include "Components.h"
 #include "Text.h"
 
 template <class OnClick>
 class Button
 {
 public:
+	//the border and the text share the button's transform group, so moving the button is a single write
 	Button(glm::vec3 position, glm::vec2 scale, Font const& font, std::string const& text, OnClick const& onClick)
-		:position{position}, scale{scale}, font{font}, text{text},
-		textQuads(text, font, getTextPosition()), onClick(onClick)
+		:scale{scale}, font{font}, text{text}, group{GameWorld::transformGroups.create(position)},
+		textQuads(text, font, getTextPosition(), group), onClick(onClick)
 	{
-		ObjectPools::quads.add(QuadComponent(position, scale, font.getCharOffset(28), font.getCharTextureScale()), &borderQuad);
+		borderEntity = GameWorld::entities.create(Transform{glm::vec3(0.0f), scale, group}, Tint{},
+			GlyphRegion{font.getCharGlyph(28)});
+
+		auto transform = GameWorld::transformGroups.getWorldTransform(group);
+		hitRegion = GameWorld::hitRegions.add(glm::vec2(transform.offset), glm::vec2(transform.offset) + scale * glm::vec2(transform.scale), transform.offset.z,
+			[this](glm::vec2 const&, int button) { if (button == GLFW_MOUSE_BUTTON_LEFT) this->onClick(); },
+			[this](bool hovered) { GameWorld::entities.get<Tint>(borderEntity).color = hovered ? glm::vec4(0.75f, 0.75f, 1.0f, 1.0f) : glm::vec4(1.0f); });
 	}
+	Button(Button const&) = delete;
 	~Button()
 	{
-		ObjectPools::quads.remove(borderQuad);
-	}
-
-	void onMousePressed(double xPos, double yPos)
-	{
-		if (xPos >= position.x && yPos >= position.y && xPos <= position.x + scale.x && yPos <= position.y + scale.y)
-		{
-			onClick();
-		}
+		GameWorld::hitRegions.remove(hitRegion);
+		GameWorld::entities.destroy(borderEntity);
+		GameWorld::transformGroups.destroy(group);
 	}
 
 	void changeText(std::string const& newText)
@@ -34,15 +37,16 @@ public:
 private:
 	glm::vec3 getTextPosition()
 	{
-		return glm::vec3(position.x + font.scale / 2.0f, position.y + scale.y / 2.0f - font.scale / 2.0f, position.z);
+		return glm::vec3(font.scale / 2.0f, scale.y / 2.0f - font.scale / 2.0f, 0.0f);
 	}
 
-	glm::vec3 position;
 	glm::vec2 scale;
 	Font font;
 	std::string text;
 
-	size_t borderQuad;
+	uint32_t group;
+	Entity borderEntity;
+	uint32_t hitRegion;
 	Text textQuads;
 
 	OnClick onClick;
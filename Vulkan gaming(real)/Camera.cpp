@@ -0,0 +1,63 @@
+#include "Camera.h"
+
+#include <algorithm>
+
+Camera::Camera(glm::vec4 const& viewport, glm::vec2 const& boardSize)
+	:viewport(viewport), boardSize(boardSize), fitScale(viewport.z / boardSize.x, viewport.w / boardSize.y)
+{
+	minZoom = std::max(1.0f, std::max(boardSize.x, boardSize.y) / CAMERA_MAX_VISIBLE_CELLS);
+	maxZoom = std::max(minZoom, std::min(boardSize.x, boardSize.y) / CAMERA_MIN_VISIBLE_CELLS);
+	fit();
+}
+
+void Camera::fit()
+{
+	target = boardSize * 0.5f;
+	zoom = minZoom;
+}
+
+void Camera::pan(glm::vec2 const& screenDelta)
+{
+	target += screenDelta / getScale();
+	clamp();
+}
+
+void Camera::zoomAt(float factor, glm::vec2 const& screenPoint)
+{
+	auto boardPoint = screenToBoard(screenPoint);
+	zoom = std::clamp(zoom * factor, minZoom, maxZoom);
+	//keep the cell under the cursor in place
+	target = boardPoint - (screenPoint - getAnchor()) / getScale();
+	clamp();
+}
+
+glm::vec2 Camera::screenToBoard(glm::vec2 const& screenPoint) const
+{
+	return target + (screenPoint - getAnchor()) / getScale();
+}
+
+bool Camera::isInViewport(glm::vec2 const& screenPoint) const
+{
+	return screenPoint.x >= viewport.x && screenPoint.x < viewport.x + viewport.z && screenPoint.y >= viewport.y && screenPoint.y < viewport.y + viewport.w;
+}
+
+glm::mat4 Camera::getViewMatrix() const
+{
+	auto anchor = getAnchor();
+	auto scale = getScale();
+	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(anchor, 0.0f));
+	view = glm::scale(view, glm::vec3(scale, 1.0f));
+	return glm::translate(view, glm::vec3(-target, 0.0f));
+}
+
+glm::vec4 Camera::getVisibleRect() const
+{
+	auto topLeft = screenToBoard({viewport.x, viewport.y});
+	auto bottomRight = screenToBoard({viewport.x + viewport.z, viewport.y + viewport.w});
+	return {topLeft, bottomRight};
+}
+
+void Camera::clamp()
+{
+	target = glm::clamp(target, glm::vec2(0.0f), boardSize);
+}
\ No newline at end of file
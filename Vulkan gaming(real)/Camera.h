@@ -0,0 +1,35 @@
+#pragma once
+
+#include "constants.h"
+
+//maps board space, where every cell is one unit, into a rect of screen space, screen space being the coordinates the ui quads use
+//zoom 1 fits the whole board into the rect, zoom is clamped so no more than CAMERA_MAX_VISIBLE_CELLS are visible along either axis
+class Camera
+{
+public:
+	Camera(glm::vec4 const& viewport, glm::vec2 const& boardSize);
+
+	void fit();
+	void pan(glm::vec2 const& screenDelta);
+	void zoomAt(float factor, glm::vec2 const& screenPoint);
+
+	glm::vec2 screenToBoard(glm::vec2 const& screenPoint) const;
+	bool isInViewport(glm::vec2 const& screenPoint) const;
+	glm::mat4 getViewMatrix() const;
+	glm::vec4 getVisibleRect() const;
+	glm::vec4 const& getViewport() const { return viewport; }
+
+private:
+	glm::vec2 getScale() const { return fitScale * zoom; }
+	glm::vec2 getAnchor() const { return glm::vec2(viewport.x, viewport.y) + glm::vec2(viewport.z, viewport.w) * 0.5f; }
+	void clamp();
+
+	glm::vec4 viewport;
+	glm::vec2 boardSize;
+	glm::vec2 fitScale;
+	float minZoom;
+	float maxZoom;
+
+	glm::vec2 target;
+	float zoom;
+};
\ No newline at end of file
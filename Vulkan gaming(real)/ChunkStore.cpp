@@ -0,0 +1,215 @@
+#include "ChunkStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "AdjacencyKernel.h"
+#include "helpers.h"
+#include "errors.h"
+
+static int64_t floorDivide(int64_t value, int64_t divisor)
+{
+	return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+std::size_t ChunkStore::ChunkKeyHash::operator()(ChunkKey const& key) const
+{
+	return static_cast<std::size_t>(mixBits(static_cast<uint64_t>(key.first) ^ mixBits(static_cast<uint64_t>(key.second))));
+}
+
+ChunkStore::ChunkStore(std::string const& filename, uint64_t seed, double mineDensity, uint64_t memoryBudget)
+	:filename(filename), file(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc), seed(seed),
+	mineThreshold(mineDensity >= 1.0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(std::ldexp(std::max(mineDensity, 0.0), 64))),
+	maxResidentChunks(std::max<std::size_t>(memoryBudget / sizeof(Chunk), 16))
+{
+	errorFatal(bool(file), "couldn't open chunk store: "s + filename);
+}
+
+ChunkStore::Cell& ChunkStore::getCell(int64_t x, int64_t y)
+{
+	ChunkKey key{floorDivide(x, BOARD_CHUNK_SIZE), floorDivide(y, BOARD_CHUNK_SIZE)};
+	auto chunk = acquireChunk(key, true);
+	return chunk->cells[(y - key.second * BOARD_CHUNK_SIZE) * BOARD_CHUNK_SIZE + x - key.first * BOARD_CHUNK_SIZE];
+}
+
+ChunkStore::Cell const* ChunkStore::findCell(int64_t x, int64_t y)
+{
+	ChunkKey key{floorDivide(x, BOARD_CHUNK_SIZE), floorDivide(y, BOARD_CHUNK_SIZE)};
+	auto chunk = acquireChunk(key, false);
+	if (!chunk) return nullptr;
+	return &chunk->cells[(y - key.second * BOARD_CHUNK_SIZE) * BOARD_CHUNK_SIZE + x - key.first * BOARD_CHUNK_SIZE];
+}
+
+bool ChunkStore::isMined(int64_t x, int64_t y) const
+{
+	//the cells around the first pressed cell are always safe so the first click can't lose
+	if (x >= safeX - 1 && x <= safeX + 1 && y >= safeY - 1 && y <= safeY + 1) return false;
+	return mixBits(seed ^ mixBits(static_cast<uint64_t>(x) ^ mixBits(static_cast<uint64_t>(y)))) < mineThreshold;
+}
+
+void ChunkStore::setSafeCell(int64_t x, int64_t y)
+{
+	auto previousX = safeX;
+	auto previousY = safeY;
+	safeX = x;
+	safeY = y;
+
+	//mines only change within both safe areas and counts one cell further, refill the resident chunks there keeping their states,
+	//stored chunks pick up the new mines when they are reloaded
+	for (auto [centerX, centerY] : { ChunkKey{ previousX, previousY }, ChunkKey{ x, y } })
+	{
+		for (auto chunkY = floorDivide(centerY - 2, BOARD_CHUNK_SIZE); chunkY <= floorDivide(centerY + 2, BOARD_CHUNK_SIZE); chunkY++)
+		{
+			for (auto chunkX = floorDivide(centerX - 2, BOARD_CHUNK_SIZE); chunkX <= floorDivide(centerX + 2, BOARD_CHUNK_SIZE); chunkX++)
+			{
+				auto found = chunks.find({ chunkX, chunkY });
+				if (found == chunks.end()) continue;
+
+				std::array<CellState, BOARD_CHUNK_SIZE * BOARD_CHUNK_SIZE> states;
+				for (std::size_t i = 0; i < states.size(); i++) states[i] = found->second.cells[i].state;
+				fillChunk(found->first, found->second);
+				for (std::size_t i = 0; i < states.size(); i++) found->second.cells[i].state = states[i];
+			}
+		}
+	}
+}
+
+void ChunkStore::reset(uint64_t newSeed)
+{
+	seed = newSeed;
+	safeX = 0;
+	safeY = 0;
+	chunks.clear();
+	lruChunks.clear();
+	recordOffsets.clear();
+	freeRecordOffsets.clear();
+	fileSize = 0;
+	file.close();
+	file.open(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+	errorFatal(bool(file), "couldn't reopen chunk store: "s + filename);
+}
+
+ChunkStore::Chunk* ChunkStore::acquireChunk(ChunkKey const& key, bool create)
+{
+	if (auto found = chunks.find(key); found != chunks.end())
+	{
+		lruChunks.splice(lruChunks.begin(), lruChunks, found->second.lruPosition);
+		return &found->second;
+	}
+
+	if (!recordOffsets.contains(key) && !create) return nullptr;
+
+	auto& chunk = createChunk(key);
+	if (!loadChunk(key, chunk)) fillChunk(key, chunk);
+	evictChunks();
+	return &chunk;
+}
+
+ChunkStore::Chunk& ChunkStore::createChunk(ChunkKey const& key)
+{
+	auto& chunk = chunks[key];
+	lruChunks.push_front(key);
+	chunk.lruPosition = lruChunks.begin();
+	return chunk;
+}
+
+void ChunkStore::fillChunk(ChunkKey const& key, Chunk& chunk)
+{
+	//hash a one cell border around the chunk as well so the kernel's counts are exact on the chunk's own cells
+	static constexpr std::size_t WINDOW_SIZE = BOARD_CHUNK_SIZE + 2;
+	int64_t originX = key.first * BOARD_CHUNK_SIZE - 1;
+	int64_t originY = key.second * BOARD_CHUNK_SIZE - 1;
+	std::array<uint8_t, WINDOW_SIZE * WINDOW_SIZE> mines;
+	for (std::size_t y = 0; y < WINDOW_SIZE; y++)
+	{
+		for (std::size_t x = 0; x < WINDOW_SIZE; x++)
+		{
+			mines[y * WINDOW_SIZE + x] = isMined(originX + static_cast<int64_t>(x), originY + static_cast<int64_t>(y));
+		}
+	}
+	std::array<uint8_t, WINDOW_SIZE * WINDOW_SIZE> adjacentMines;
+	countAdjacentMines(mines.data(), WINDOW_SIZE, WINDOW_SIZE, adjacentMines.data());
+
+	for (std::size_t y = 0; y < BOARD_CHUNK_SIZE; y++)
+	{
+		for (std::size_t x = 0; x < BOARD_CHUNK_SIZE; x++)
+		{
+			auto& cell = chunk.cells[y * BOARD_CHUNK_SIZE + x];
+			auto windowIndex = (y + 1) * WINDOW_SIZE + x + 1;
+			cell.mined = mines[windowIndex] != 0;
+			cell.adjacentMines = adjacentMines[windowIndex];
+			cell.state = CellState::eCovered;
+		}
+	}
+}
+
+bool ChunkStore::loadChunk(ChunkKey const& key, Chunk& chunk)
+{
+	auto found = recordOffsets.find(key);
+	if (found == recordOffsets.end()) return false;
+
+	std::array<uint8_t, RECORD_STATE_BYTES> states;
+	file.seekg(static_cast<std::streamoff>(found->second + sizeof(int64_t) * 2));
+	file.read(reinterpret_cast<char*>(states.data()), states.size());
+	errorFatal(bool(file), "couldn't read chunk from store: "s + filename);
+
+	//mines and counts are recomputed from the hash, only the states come from disk
+	fillChunk(key, chunk);
+	for (std::size_t i = 0; i < chunk.cells.size(); i++)
+	{
+		chunk.cells[i].state = static_cast<CellState>((states[i / 4] >> (i % 4 * 2)) & 3);
+	}
+	return true;
+}
+
+void ChunkStore::writeChunk(ChunkKey const& key, Chunk const& chunk)
+{
+	//a chunk without progress is recreated from the hash, storing it would only grow the index and file
+	if (std::ranges::all_of(chunk.cells, [](Cell const& cell) { return cell.state == CellState::eCovered; }))
+	{
+		releaseRecord(key);
+		return;
+	}
+
+	std::array<uint8_t, RECORD_SIZE> record{};
+	std::memcpy(record.data(), &key.first, sizeof(int64_t));
+	std::memcpy(record.data() + sizeof(int64_t), &key.second, sizeof(int64_t));
+	for (std::size_t i = 0; i < chunk.cells.size(); i++)
+	{
+		record[sizeof(int64_t) * 2 + i / 4] |= static_cast<uint8_t>(static_cast<uint8_t>(chunk.cells[i].state) << (i % 4 * 2));
+	}
+
+	//records have a fixed size so a revisited chunk is rewritten in place and released records are reused
+	auto [offset, inserted] = recordOffsets.try_emplace(key, fileSize);
+	if (inserted && !freeRecordOffsets.empty())
+	{
+		offset->second = freeRecordOffsets.back();
+		freeRecordOffsets.pop_back();
+	}
+	else if (inserted) fileSize += RECORD_SIZE;
+	file.seekp(static_cast<std::streamoff>(offset->second));
+	file.write(reinterpret_cast<char const*>(record.data()), record.size());
+	errorFatal(bool(file), "couldn't write chunk to store: "s + filename);
+}
+
+void ChunkStore::releaseRecord(ChunkKey const& key)
+{
+	auto found = recordOffsets.find(key);
+	if (found == recordOffsets.end()) return;
+
+	freeRecordOffsets.push_back(found->second);
+	recordOffsets.erase(found);
+}
+
+void ChunkStore::evictChunks()
+{
+	while (chunks.size() > maxResidentChunks)
+	{
+		auto key = lruChunks.back();
+		writeChunk(key, chunks.at(key));
+		chunks.erase(key);
+		lruChunks.pop_back();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gameConstants.h"
+#include "BoardGenerator.h"
+
+//cells of an unbounded board, mines come from a stateless hash of the seed and coordinates so only the player's progress needs storing
+//chunks are created the first time one of their cells is touched and kept least recently used within the memory budget,
+//evicted chunks holding progress are written to fixed size records in the store file, two bits per cell, and read back when revisited,
+//untouched chunks are regenerated from the hash instead so the index and file only grow with the cells the player actually changed
+class ChunkStore
+{
+	using Cell = BoardLayout::Cell;
+	using CellState = BoardLayout::CellState;
+	using ChunkKey = std::pair<int64_t, int64_t>;
+
+	struct ChunkKeyHash
+	{
+		std::size_t operator()(ChunkKey const& key) const;
+	};
+	struct Chunk
+	{
+		std::array<Cell, BOARD_CHUNK_SIZE * BOARD_CHUNK_SIZE> cells;
+		std::list<ChunkKey>::iterator lruPosition;
+	};
+
+public:
+	ChunkStore(std::string const& filename, uint64_t seed, double mineDensity, uint64_t memoryBudget);
+
+	Cell& getCell(int64_t x, int64_t y);
+	Cell const* findCell(int64_t x, int64_t y);
+	bool isMined(int64_t x, int64_t y) const;
+	//moves the always safe 3x3 area to be centered on this cell, meant for the first press before any cell is uncovered
+	void setSafeCell(int64_t x, int64_t y);
+	void reset(uint64_t newSeed);
+
+	std::size_t getResidentChunkCount() const { return chunks.size(); }
+	std::size_t getStoredChunkCount() const { return recordOffsets.size(); }
+
+private:
+	static constexpr std::size_t RECORD_STATE_BYTES = BOARD_CHUNK_SIZE * BOARD_CHUNK_SIZE / 4;
+	static constexpr std::size_t RECORD_SIZE = sizeof(int64_t) * 2 + RECORD_STATE_BYTES;
+
+	Chunk* acquireChunk(ChunkKey const& key, bool create);
+	Chunk& createChunk(ChunkKey const& key);
+	void fillChunk(ChunkKey const& key, Chunk& chunk);
+	bool loadChunk(ChunkKey const& key, Chunk& chunk);
+	void writeChunk(ChunkKey const& key, Chunk const& chunk);
+	void releaseRecord(ChunkKey const& key);
+	void evictChunks();
+
+	std::string filename;
+	std::fstream file;
+	uint64_t seed;
+	uint64_t mineThreshold;
+	std::size_t maxResidentChunks;
+
+	std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> chunks;
+	std::list<ChunkKey> lruChunks;
+	std::unordered_map<ChunkKey, uint64_t, ChunkKeyHash> recordOffsets;
+	std::vector<uint64_t> freeRecordOffsets;
+	uint64_t fileSize{};
+	int64_t safeX{};
+	int64_t safeY{};
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "gameConstants.h"
+
+//2d grid stored chunk by chunk, every ChunkSize x ChunkSize chunk is contiguous so neighbouring cells share cache lines and a chunk can be copied as one block
+//edge chunks are padded to full size, the padding cells are never visible through the accessors
+template<class T, uint32_t ChunkSize = BOARD_CHUNK_SIZE>
+class ChunkedGrid
+{
+public:
+	static constexpr std::size_t CHUNK_AREA = std::size_t(ChunkSize) * ChunkSize;
+
+	ChunkedGrid() = default;
+	ChunkedGrid(std::size_t width, std::size_t height, T const& value = T{})
+		:width(width), height(height), chunkCountX((width + ChunkSize - 1) / ChunkSize), chunkCountY((height + ChunkSize - 1) / ChunkSize),
+		storage(chunkCountX * chunkCountY * CHUNK_AREA, value)
+	{}
+
+	T& operator()(std::size_t x, std::size_t y) { return storage[getStorageIndex(x, y)]; }
+	T const& operator()(std::size_t x, std::size_t y) const { return storage[getStorageIndex(x, y)]; }
+
+	std::size_t getStorageIndex(std::size_t x, std::size_t y) const
+	{
+		return getChunkIndex(x, y) * CHUNK_AREA + (y % ChunkSize) * ChunkSize + x % ChunkSize;
+	}
+	std::size_t getChunkIndex(std::size_t x, std::size_t y) const { return (y / ChunkSize) * chunkCountX + x / ChunkSize; }
+
+	void fill(T const& value) { std::fill(storage.begin(), storage.end(), value); }
+	T* getChunkData(std::size_t chunk) { return storage.data() + chunk * CHUNK_AREA; }
+	T const* getChunkData(std::size_t chunk) const { return storage.data() + chunk * CHUNK_AREA; }
+
+	std::size_t getWidth() const { return width; }
+	std::size_t getHeight() const { return height; }
+	std::size_t getCellCount() const { return width * height; }
+	std::size_t getChunkCountX() const { return chunkCountX; }
+	std::size_t getChunkCountY() const { return chunkCountY; }
+	std::size_t getChunkCount() const { return chunkCountX * chunkCountY; }
+	T const* getData() const { return storage.data(); }
+	std::size_t getStorageSize() const { return storage.size(); }
+
+private:
+	std::size_t width{};
+	std::size_t height{};
+	std::size_t chunkCountX{};
+	std::size_t chunkCountY{};
+	std::vector<T> storage;
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "constants.h"
+
+//quad with its top left corner and depth at position, relative to its transform group
+struct Transform
+{
+	glm::vec3 position;
+	glm::vec2 scale;
+	uint32_t group{};
+};
+
+struct Tint
+{
+	glm::vec4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+//entry of the font's glyph table drawn on the quad
+struct GlyphRegion
+{
+	uint16_t glyph;
+};
+
+//the entity is destroyed once elapsed reaches duration, both in seconds
+struct Lifetime
+{
+	double elapsed{};
+	double duration{};
+
+	double getProgress() const { return elapsed / duration; }
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//writes the signed distance field of the alpha mask in source into target, downscaled by scale
+//0.5 lies on the glyph edge, 1.0 is spread source pixels inside and 0.0 spread source pixels outside
+inline void generateDistanceField(uint8_t const* source, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t sourceStride, uint32_t sourceChannels,
+	uint8_t* target, uint32_t targetWidth, uint32_t targetHeight, uint32_t targetStride, uint32_t scale, float spread)
+{
+	auto isInside = [&](int64_t x, int64_t y)
+	{
+		return source[(y * sourceStride + x) * sourceChannels + sourceChannels - 1] >= 128;
+	};
+
+	int64_t radius = static_cast<int64_t>(std::ceil(spread * scale));
+	for (uint32_t ty = 0; ty < targetHeight; ty++)
+	{
+		for (uint32_t tx = 0; tx < targetWidth; tx++)
+		{
+			float sampleX = (tx + 0.5f) * scale;
+			float sampleY = (ty + 0.5f) * scale;
+			int64_t centerX = std::min<int64_t>(static_cast<int64_t>(sampleX), sourceWidth - 1);
+			int64_t centerY = std::min<int64_t>(static_cast<int64_t>(sampleY), sourceHeight - 1);
+			bool inside = isInside(centerX, centerY);
+
+			float closest = static_cast<float>(radius);
+			for (int64_t y = std::max<int64_t>(centerY - radius, 0); y <= std::min<int64_t>(centerY + radius, sourceHeight - 1); y++)
+			{
+				for (int64_t x = std::max<int64_t>(centerX - radius, 0); x <= std::min<int64_t>(centerX + radius, sourceWidth - 1); x++)
+				{
+					if (isInside(x, y) != inside)
+					{
+						closest = std::min(closest, std::hypot(x + 0.5f - sampleX, y + 0.5f - sampleY));
+					}
+				}
+			}
+
+			float distance = (inside ? closest : -closest) / (2.0f * radius) + 0.5f;
+			target[ty * targetStride + tx] = static_cast<uint8_t>(std::clamp(distance, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "EntityWorld.h"
+
+#include <atomic>
+
+#include "logging.h"
+
+static std::array<std::size_t, MAX_COMPONENT_TYPES> componentSizes{};
+
+std::size_t EntityWorld::registerComponentType(std::size_t size)
+{
+	static std::atomic<std::size_t> nextId{ 0 };
+	auto id = nextId.fetch_add(1, std::memory_order_relaxed);
+	errorFatal(id < MAX_COMPONENT_TYPES, "too many component types, raise MAX_COMPONENT_TYPES"s);
+	componentSizes[id] = size;
+	return id;
+}
+
+void EntityWorld::destroy(Entity entity)
+{
+	if (!isAlive(entity)) return;
+
+	auto& slot = slots[entity.index];
+	removeRow(slot.archetype, slot.row);
+	slot.alive = false;
+	slot.generation++;
+	freeSlots.push_back(entity.index);
+}
+
+uint32_t EntityWorld::getArchetype(Mask const& mask)
+{
+	if (auto found = archetypeIndices.find(mask); found != archetypeIndices.end()) return found->second;
+
+	Archetype archetype{ mask };
+	archetype.columnIndices.fill(NO_COLUMN);
+	for (std::size_t id = 0; id < MAX_COMPONENT_TYPES; id++)
+	{
+		if (!mask.test(id)) continue;
+		archetype.columnIndices[id] = static_cast<uint32_t>(archetype.columns.size());
+		archetype.componentIds.push_back(id);
+		archetype.columns.push_back(Column{ componentSizes[id] });
+	}
+
+	auto index = static_cast<uint32_t>(archetypes.size());
+	archetypes.push_back(std::move(archetype));
+	archetypeIndices.emplace(mask, index);
+	return index;
+}
+
+Entity EntityWorld::allocateEntity(uint32_t archetypeIndex)
+{
+	Entity entity;
+	if (!freeSlots.empty())
+	{
+		entity.index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		entity.index = static_cast<uint32_t>(slots.size());
+		slots.emplace_back();
+	}
+
+	auto& slot = slots[entity.index];
+	entity.generation = slot.generation;
+	slot.alive = true;
+	slot.archetype = archetypeIndex;
+	slot.row = appendRow(archetypes[archetypeIndex], entity);
+	return entity;
+}
+
+uint32_t EntityWorld::appendRow(Archetype& archetype, Entity entity)
+{
+	for (auto& column : archetype.columns)
+	{
+		column.data.resize(column.data.size() + column.elementSize);
+	}
+	archetype.entities.push_back(entity);
+	return static_cast<uint32_t>(archetype.entities.size() - 1);
+}
+
+//the last row takes the place of the removed one
+void EntityWorld::removeRow(uint32_t archetypeIndex, uint32_t row)
+{
+	auto& archetype = archetypes[archetypeIndex];
+	auto lastRow = archetype.entities.size() - 1;
+	if (row != lastRow)
+	{
+		for (auto& column : archetype.columns)
+		{
+			std::memcpy(column.data.data() + row * column.elementSize, column.data.data() + lastRow * column.elementSize, column.elementSize);
+		}
+		archetype.entities[row] = archetype.entities[lastRow];
+		slots[archetype.entities[row].index].row = row;
+	}
+	for (auto& column : archetype.columns)
+	{
+		column.data.resize(column.data.size() - column.elementSize);
+	}
+	archetype.entities.pop_back();
+}
+
+//components both archetypes have are copied over, the ones only the target has start zeroed
+void EntityWorld::moveEntity(Entity entity, uint32_t targetIndex)
+{
+	auto& slot = slots[entity.index];
+	auto sourceIndex = slot.archetype;
+	auto sourceRow = slot.row;
+	auto targetRow = appendRow(archetypes[targetIndex], entity);
+
+	auto& source = archetypes[sourceIndex];
+	auto& target = archetypes[targetIndex];
+	for (auto id : target.componentIds)
+	{
+		if (source.columnIndices[id] == NO_COLUMN) continue;
+		auto const& sourceColumn = source.columns[source.columnIndices[id]];
+		auto& targetColumn = target.columns[target.columnIndices[id]];
+		std::memcpy(targetColumn.data.data() + targetRow * targetColumn.elementSize, sourceColumn.data.data() + sourceRow * sourceColumn.elementSize,
+			sourceColumn.elementSize);
+	}
+
+	removeRow(sourceIndex, sourceRow);
+	slot.archetype = targetIndex;
+	slot.row = targetRow;
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.h"
+#include "HitGrid.h"
+#include "ThreadPool.h"
+#include "TransformGroups.h"
+
+//handle of an entity, the generation tells a destroyed entity apart from a later one reusing its slot
+struct Entity
+{
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+	uint32_t index = INVALID_INDEX;
+	uint32_t generation{};
+
+	bool isValid() const { return index != INVALID_INDEX; }
+	bool operator==(Entity const&) const = default;
+};
+
+//entities are grouped into archetypes by the exact set of components they have, an archetype keeps every component in its own contiguous array
+//systems run over those arrays directly, adding or removing a component moves the entity's row to another archetype
+//components have to be trivially copyable since rows are moved with memcpy
+class EntityWorld
+{
+	using Mask = std::bitset<MAX_COMPONENT_TYPES>;
+	static constexpr uint32_t NO_COLUMN = std::numeric_limits<uint32_t>::max();
+
+	struct Column
+	{
+		std::size_t elementSize{};
+		std::vector<std::byte> data{};
+	};
+	struct Archetype
+	{
+		Mask mask{};
+		std::array<uint32_t, MAX_COMPONENT_TYPES> columnIndices{};
+		std::vector<std::size_t> componentIds{};
+		std::vector<Column> columns{};
+		std::vector<Entity> entities{};
+	};
+	struct Slot
+	{
+		uint32_t generation{};
+		uint32_t archetype{};
+		uint32_t row{};
+		bool alive = false;
+	};
+
+public:
+	template<class... Components>
+	Entity create(Components const&... components)
+	{
+		auto archetypeIndex = getArchetype(getMask<Components...>());
+		auto entity = allocateEntity(archetypeIndex);
+		(writeComponent(entity, components), ...);
+		return entity;
+	}
+	void destroy(Entity entity);
+	bool isAlive(Entity entity) const { return entity.index < slots.size() && slots[entity.index].alive && slots[entity.index].generation == entity.generation; }
+
+	template<class Component>
+	bool has(Entity entity) const
+	{
+		return archetypes[slots[entity.index].archetype].mask.test(getComponentId<Component>());
+	}
+	template<class Component>
+	Component& get(Entity entity)
+	{
+		auto const& slot = slots[entity.index];
+		return getColumn<Component>(archetypes[slot.archetype])[slot.row];
+	}
+	template<class Component>
+	void add(Entity entity, Component const& component)
+	{
+		if (!has<Component>(entity))
+		{
+			auto mask = archetypes[slots[entity.index].archetype].mask;
+			moveEntity(entity, getArchetype(mask.set(getComponentId<Component>())));
+		}
+		writeComponent(entity, component);
+	}
+	template<class Component>
+	void remove(Entity entity)
+	{
+		if (!has<Component>(entity)) return;
+		auto mask = archetypes[slots[entity.index].archetype].mask;
+		moveEntity(entity, getArchetype(mask.reset(getComponentId<Component>())));
+	}
+
+	//function(count, entities, arrays...) once for every archetype that has all of the components
+	template<class... Components, class Function>
+	void forEachArray(Function&& function)
+	{
+		auto query = getMask<Components...>();
+		for (auto& archetype : archetypes)
+		{
+			if ((archetype.mask & query) != query || archetype.entities.empty()) continue;
+			function(archetype.entities.size(), archetype.entities.data(), getColumn<Components>(archetype)...);
+		}
+	}
+	//function(entity, components...) for every entity that has all of the components, it must not create, destroy or restructure entities
+	template<class... Components, class Function>
+	void forEach(Function&& function)
+	{
+		forEachArray<Components...>([&](std::size_t count, Entity const* entities, Components*... columns)
+			{
+				for (std::size_t i = 0; i < count; i++) function(entities[i], columns[i]...);
+			});
+	}
+	//function(queryIndex, components...) in batches of ENTITY_SYSTEM_BATCH_SIZE rows spread over the pool, queryIndex counts the matching entities from zero
+	//a query that fits one batch runs on the calling thread, function has to be safe to call concurrently on different rows
+	template<class... Components, class Function>
+	void parallelForEach(ThreadPool& threadPool, Function const& function)
+	{
+		TaskGroup batches(threadPool);
+		std::size_t queryOffset = 0;
+		bool runInline = count<Components...>() <= ENTITY_SYSTEM_BATCH_SIZE;
+		forEachArray<Components...>([&](std::size_t rowCount, Entity const*, Components*... columns)
+			{
+				for (std::size_t begin = 0; begin < rowCount; begin += ENTITY_SYSTEM_BATCH_SIZE)
+				{
+					auto end = std::min(begin + ENTITY_SYSTEM_BATCH_SIZE, rowCount);
+					auto batch = [&function, begin, end, queryOffset, columns...]()
+					{
+						for (auto i = begin; i < end; i++) function(queryOffset + i, columns[i]...);
+					};
+					if (runInline) batch();
+					else batches.run(batch);
+				}
+				queryOffset += rowCount;
+			});
+		batches.wait();
+	}
+
+	template<class... Components>
+	std::size_t count() const
+	{
+		auto query = getMask<Components...>();
+		std::size_t total = 0;
+		for (auto const& archetype : archetypes)
+		{
+			if ((archetype.mask & query) == query) total += archetype.entities.size();
+		}
+		return total;
+	}
+	std::size_t getEntityCount() const { return slots.size() - freeSlots.size(); }
+	std::size_t getArchetypeCount() const { return archetypes.size(); }
+
+private:
+	static std::size_t registerComponentType(std::size_t size);
+	template<class Component>
+	static std::size_t getComponentId()
+	{
+		static_assert(std::is_trivially_copyable_v<Component> && alignof(Component) <= alignof(std::max_align_t));
+		static std::size_t const id = registerComponentType(sizeof(Component));
+		return id;
+	}
+	template<class... Components>
+	static Mask getMask()
+	{
+		Mask mask;
+		(mask.set(getComponentId<Components>()), ...);
+		return mask;
+	}
+	template<class Component>
+	static Component* getColumn(Archetype& archetype)
+	{
+		return reinterpret_cast<Component*>(archetype.columns[archetype.columnIndices[getComponentId<Component>()]].data.data());
+	}
+	template<class Component>
+	void writeComponent(Entity entity, Component const& component)
+	{
+		auto const& slot = slots[entity.index];
+		std::memcpy(getColumn<Component>(archetypes[slot.archetype]) + slot.row, &component, sizeof(Component));
+	}
+
+	uint32_t getArchetype(Mask const& mask);
+	Entity allocateEntity(uint32_t archetypeIndex);
+	//appends a zeroed row, returns its index
+	uint32_t appendRow(Archetype& archetype, Entity entity);
+	void removeRow(uint32_t archetypeIndex, uint32_t row);
+	void moveEntity(Entity entity, uint32_t targetIndex);
+
+	std::vector<Archetype> archetypes;
+	std::unordered_map<Mask, uint32_t> archetypeIndices;
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+};
+
+//entities of everything drawn as quads and the groups their transforms are relative to, both are uploaded each frame
+//clicks and hovers are routed to widgets through the hit regions
+struct GameWorld
+{
+	inline static EntityWorld entities;
+	inline static TransformGroups transformGroups;
+	inline static HitGrid hitRegions;
+};
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "constants.h"
+
+struct ChannelStatistics
+{
+	uint64_t publishedCount;
+	uint64_t droppedCount;
+	std::size_t highWaterMark;
+};
+
+//fixed capacity queue of one event type, consumers read pending events in place and consume them once handled
+//events published while a batch is being handled stay queued for the next batch
+template<class Event, std::size_t Capacity = EVENT_CHANNEL_CAPACITY>
+class EventChannel
+{
+public:
+	EventChannel() = default;
+	EventChannel(EventChannel const&) = delete;
+	EventChannel& operator=(EventChannel const&) = delete;
+
+	bool publish(Event const& event)
+	{
+		if (count == Capacity)
+		{
+			statistics.droppedCount++;
+			return false;
+		}
+		events[count++] = event;
+		statistics.publishedCount++;
+		statistics.highWaterMark = std::max(statistics.highWaterMark, count);
+		return true;
+	}
+
+	std::span<Event const> getEvents() const { return {events.data(), count}; }
+
+	void consume(std::size_t consumedCount)
+	{
+		consumedCount = std::min(consumedCount, count);
+		std::move(events.begin() + consumedCount, events.begin() + count, events.begin());
+		count -= consumedCount;
+	}
+
+	template<class Handler>
+	std::size_t drain(Handler&& handler)
+	{
+		auto pendingCount = count;
+		for (std::size_t i = 0; i < pendingCount; i++)
+		{
+			handler(std::as_const(events[i]));
+		}
+		consume(pendingCount);
+		return pendingCount;
+	}
+
+	ChannelStatistics getStatistics() const { return statistics; }
+
+private:
+	std::array<Event, Capacity> events{};
+	std::size_t count{};
+	ChannelStatistics statistics{};
+};
+
+//bounded lock-free queue that any thread can publish into and one thread drains
+//each slot carries a sequence number telling whether it is free for the producer at that position or ready for the consumer
+//a full channel rejects the event and counts it, producers never block
+template<class Event, std::size_t Capacity = EVENT_CHANNEL_CAPACITY>
+class ConcurrentEventChannel
+{
+	static_assert(std::has_single_bit(Capacity), "concurrent channel capacity must be a power of two");
+
+	struct Slot
+	{
+		std::atomic<std::size_t> sequence;
+		Event event;
+	};
+
+public:
+	ConcurrentEventChannel()
+	{
+		for (std::size_t i = 0; i < Capacity; i++)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	ConcurrentEventChannel(ConcurrentEventChannel const&) = delete;
+	ConcurrentEventChannel& operator=(ConcurrentEventChannel const&) = delete;
+
+	//any thread
+	bool publish(Event const& event)
+	{
+		auto position = enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto& slot = slots[position & (Capacity - 1)];
+			auto sequence = slot.sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+			if (difference == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.event = event;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					publishedCount.fetch_add(1, std::memory_order_relaxed);
+					updateHighWaterMark(position + 1 - dequeuePosition.load(std::memory_order_relaxed));
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//consumer thread only, events published after the drain started are left for the next one
+	template<class Handler>
+	std::size_t drain(Handler&& handler)
+	{
+		auto endPosition = enqueuePosition.load(std::memory_order_acquire);
+		auto position = dequeuePosition.load(std::memory_order_relaxed);
+		std::size_t handledCount = 0;
+		while (position != endPosition)
+		{
+			auto& slot = slots[position & (Capacity - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != position + 1) break;
+
+			handler(std::as_const(slot.event));
+			slot.sequence.store(position + Capacity, std::memory_order_release);
+			position++;
+			dequeuePosition.store(position, std::memory_order_relaxed);
+			handledCount++;
+		}
+		return handledCount;
+	}
+
+	ChannelStatistics getStatistics() const
+	{
+		return {publishedCount.load(std::memory_order_relaxed), droppedCount.load(std::memory_order_relaxed), highWaterMark.load(std::memory_order_relaxed)};
+	}
+
+private:
+	void updateHighWaterMark(std::size_t occupancy)
+	{
+		auto current = highWaterMark.load(std::memory_order_relaxed);
+		while (occupancy > current && !highWaterMark.compare_exchange_weak(current, occupancy, std::memory_order_relaxed));
+	}
+
+	std::array<Slot, Capacity> slots;
+	alignas(64) std::atomic<std::size_t> enqueuePosition{};
+	alignas(64) std::atomic<std::size_t> dequeuePosition{};
+	alignas(64) std::atomic<uint64_t> publishedCount{};
+	std::atomic<uint64_t> droppedCount{};
+	std::atomic<std::size_t> highWaterMark{};
+};
+
+//marks an event type in an EventBus list as published from other threads
+template<class Event>
+struct Concurrent {};
+
+//one channel per event type in the list, the list is fixed at compile time
+template<class... Events>
+class EventBus
+{
+	template<class Event>
+	static constexpr bool isConcurrent = (std::is_same_v<Events, Concurrent<Event>> || ...);
+
+	template<class Listed>
+	struct ChannelFor { using Type = EventChannel<Listed>; };
+	template<class Event>
+	struct ChannelFor<Concurrent<Event>> { using Type = ConcurrentEventChannel<Event>; };
+
+public:
+	template<class Event>
+	using Channel = std::conditional_t<isConcurrent<Event>, ConcurrentEventChannel<Event>, EventChannel<Event>>;
+
+	template<class Event>
+	Channel<Event>& getChannel() { return std::get<Channel<Event>>(channels); }
+	template<class Event>
+	Channel<Event> const& getChannel() const { return std::get<Channel<Event>>(channels); }
+
+	template<class Event>
+	bool publish(Event const& event) { return getChannel<Event>().publish(event); }
+	template<class Event, class Handler>
+	std::size_t drain(Handler&& handler) { return getChannel<Event>().drain(std::forward<Handler>(handler)); }
+
+private:
+	std::tuple<typename ChannelFor<Events>::Type...> channels;
+};
\ No newline at end of file
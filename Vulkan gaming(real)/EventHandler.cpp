@@ -1,5 +1,7 @@
 #include "EventHandler.h"
 
+#include <cmath>
+
 #include "Game.h"
 
 EventHandler::EventHandler()
@@ -10,80 +12,135 @@ void EventHandler::pollEvents()
 	glfwPollEvents();
 }
 
-std::unordered_set<int> EventHandler::getPressedKeys()
-{
-	std::unordered_set<int> result = keysPressed;
-	keysPressed.clear();
-	return result;
-}
-
-std::unordered_set<int> EventHandler::getHeldKeys()
-{
-	return keysHeld;
-}
-
-std::unordered_set<int> EventHandler::getPressedMouseButtons()
+EventHandler::EventQueue::View EventHandler::getEvents() const
 {
-	std::unordered_set<int> result = mouseButtonsPressed;
-	mouseButtonsPressed.clear();
-	return result;
+	return events.getView();
 }
 
-std::unordered_set<int> EventHandler::getHeldMouseButtons()
+void EventHandler::consumeEvents(EventQueue::View const& consumedEvents)
 {
-	return mouseButtonsHeld;
+	for (auto&& event : consumedEvents)
+	{
+		switch (event.type)
+		{
+		case EventType::eKeyPress:
+			keysHeld.set(event.code);
+			break;
+		case EventType::eKeyRelease:
+			keysHeld.reset(event.code);
+			break;
+		case EventType::eMouseButtonPress:
+			mouseButtonsHeld.set(event.code);
+			break;
+		case EventType::eMouseButtonRelease:
+			mouseButtonsHeld.reset(event.code);
+			break;
+		default:
+			break;
+		}
+	}
+	events.consume(consumedEvents);
 }
 
-std::unordered_set<int> EventHandler::getReleasedMouseButtons()
+std::pair<double, double> EventHandler::getCursorCoordinates() const
 {
-	std::unordered_set<int> result = mouseButtonsReleased;
-	mouseButtonsReleased.clear();
-	return result;
+	if (windowWidth == 0 || windowHeight == 0) return {-1.0, -1.0};
+	return {cursorX / windowWidth * 2.0 - 1.0, cursorY / windowHeight * 2.0 - 1.0};
 }
 
-bool EventHandler::getFramebufferResized()
+void EventHandler::queueEvent(InputEvent const& event)
 {
-	auto result = framebufferResized;
-	framebufferResized = false;
-	return result;
+	if (!events.push(event))
+	{
+		droppedEventCount++;
+	}
 }
 
 void EventHandler::onMouseButtonEvent(int button, int action, int)
 {
+	if (!liveInputEnabled || button < 0 || button > GLFW_MOUSE_BUTTON_LAST) return;
+
+	auto [xPos, yPos] = getCursorCoordinates();
 	if (action == GLFW_PRESS)
 	{
-		mouseButtonsPressed.insert(button);
-		mouseButtonsHeld.insert(button);
+		pushEvent(EventType::eMouseButtonPress, button, xPos, yPos);
 	}
 	else if (action == GLFW_RELEASE)
 	{
-		mouseButtonsHeld.erase(button);
-		mouseButtonsReleased.insert(button);
+		pushEvent(EventType::eMouseButtonRelease, button, xPos, yPos);
 	}
 }
 
 void EventHandler::onKeyEvent(int key, int, int action, int)
 {
+	if (!liveInputEnabled || key < 0 || key > GLFW_KEY_LAST) return;
+
+	auto [xPos, yPos] = getCursorCoordinates();
 	if (action == GLFW_PRESS)
 	{
-		keysPressed.insert(key);
-		keysHeld.insert(key);
+		pushEvent(EventType::eKeyPress, key, xPos, yPos);
 	}
 	else if (action == GLFW_RELEASE)
 	{
-		keysHeld.erase(key);
+		pushEvent(EventType::eKeyRelease, key, xPos, yPos);
 	}
 }
 
-void EventHandler::onFramebufferResizeEvent()
+void EventHandler::onCursorPositionEvent(double xPos, double yPos)
+{
+	cursorX = xPos;
+	cursorY = yPos;
+	cursorTime = glfwGetTime();
+}
+
+void EventHandler::onWindowSizeEvent(int width, int height)
+{
+	windowWidth = width;
+	windowHeight = height;
+}
+
+void EventHandler::onScrollEvent(double, double yOffset)
 {
-	framebufferResized = true;
+	if (!liveInputEnabled || yOffset == 0.0) return;
+
+	//smooth scrolling reports fractions of a step, round those away from zero so they still count
+	int steps = static_cast<int>(yOffset > 0.0 ? std::ceil(yOffset) : std::floor(yOffset));
+	auto [xPos, yPos] = getCursorCoordinates();
+	pushEvent(EventType::eMouseScroll, steps, xPos, yPos);
+}
+
+void EventHandler::onFramebufferResizeEvent(int width, int height)
+{
+	pushEvent(EventType::eFramebufferResize, 0, width, height);
+}
+
+void EventHandler::pushEvent(EventType type, int code, double x, double y)
+{
+	queueEvent(InputEvent{glfwGetTime(), type, code, x, y});
+}
+
+void cursorPositionCallback(GLFWwindow* window, double xPos, double yPos)
+{
+	auto eventHandler = reinterpret_cast<EventHandler*>(glfwGetWindowUserPointer(window));
+	eventHandler->onCursorPositionEvent(xPos, yPos);
+}
+
+void windowSizeCallback(GLFWwindow* window, int width, int height)
+{
+	auto eventHandler = reinterpret_cast<EventHandler*>(glfwGetWindowUserPointer(window));
+	eventHandler->onWindowSizeEvent(width, height);
+}
+
+void scrollCallback(GLFWwindow* window, double xOffset, double yOffset)
+{
+	auto eventHandler = reinterpret_cast<EventHandler*>(glfwGetWindowUserPointer(window));
+	eventHandler->onScrollEvent(xOffset, yOffset);
 }
 
-void framebufferResizeCallback(GLFWwindow* window, int, int)
+void framebufferResizeCallback(GLFWwindow* window, int width, int height)
 {
 	auto eventHandler = reinterpret_cast<EventHandler*>(glfwGetWindowUserPointer(window));
-	eventHandler->onFramebufferResizeEvent();
+	eventHandler->onFramebufferResizeEvent(width, height);
 }
 
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
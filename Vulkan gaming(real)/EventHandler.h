@@ -1,51 +1,82 @@
 #pragma once
 
-#include <unordered_set>
+#include <bitset>
 
 #include "constants.h"
+#include "RingBuffer.h"
 
 class Game;
 
 enum class EventType
 {
-	FramebufferResize, Key
+	eKeyPress, eKeyRelease, eMouseButtonPress, eMouseButtonRelease, eFramebufferResize, eMouseScroll
+};
+
+//x and y hold the normalized cursor position at the time of the event, or the new size for framebuffer resizes
+//code holds the key or button, or the number of wheel steps for scrolls
+struct InputEvent
+{
+	double time;
+	EventType type;
+	int code;
+	double x, y;
 };
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+void cursorPositionCallback(GLFWwindow* window, double xPos, double yPos);
+void windowSizeCallback(GLFWwindow* window, int width, int height);
+void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
 void framebufferResizeCallback(GLFWwindow* window, int width, int height);
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
+//callbacks queue timestamped events, the consumer walks them in order and held state follows the consumed events
 class EventHandler
 {
 public:
+	using EventQueue = RingBuffer<InputEvent, INPUT_EVENT_QUEUE_SIZE>;
+	using KeySet = std::bitset<GLFW_KEY_LAST + 1>;
+	using MouseButtonSet = std::bitset<GLFW_MOUSE_BUTTON_LAST + 1>;
+
 	explicit EventHandler();
 
 	void pollEvents();
 
-	std::unordered_set<int> getPressedKeys();
-	std::unordered_set<int> getHeldKeys();
+	EventQueue::View getEvents() const;
+	void consumeEvents(EventQueue::View const& events);
+	void queueEvent(InputEvent const& event);
+	void setLiveInputEnabled(bool enabled) { liveInputEnabled = enabled; }
+	uint64_t getDroppedEventCount() const { return droppedEventCount; }
 
-	std::unordered_set<int> getPressedMouseButtons();
-	std::unordered_set<int> getHeldMouseButtons();
-	std::unordered_set<int> getReleasedMouseButtons();
+	KeySet const& getHeldKeys() const { return keysHeld; }
+	MouseButtonSet const& getHeldMouseButtons() const { return mouseButtonsHeld; }
 
-	bool getFramebufferResized();
+	std::pair<double, double> getCursorCoordinates() const;
+	double getCursorTime() const { return cursorTime; }
 
 private:
 	void onMouseButtonEvent(int button, int action, int mods);
 	void onKeyEvent(int key, int scancode, int action, int mods);
-	void onFramebufferResizeEvent();
+	void onCursorPositionEvent(double xPos, double yPos);
+	void onWindowSizeEvent(int width, int height);
+	void onScrollEvent(double xOffset, double yOffset);
+	void onFramebufferResizeEvent(int width, int height);
+	void pushEvent(EventType type, int code, double x, double y);
 
-	std::unordered_set<int> keysPressed;
-	std::unordered_set<int> keysHeld;
+	EventQueue events;
+	uint64_t droppedEventCount{};
+	bool liveInputEnabled = true;
 
-	std::unordered_set<int> mouseButtonsPressed;
-	std::unordered_set<int> mouseButtonsHeld;
-	std::unordered_set<int> mouseButtonsReleased;
+	KeySet keysHeld;
+	MouseButtonSet mouseButtonsHeld;
 
-	bool framebufferResized = false;
+	double cursorX{}, cursorY{};
+	double cursorTime{};
+	int windowWidth{}, windowHeight{};
 
 	friend void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+	friend void cursorPositionCallback(GLFWwindow* window, double xPos, double yPos);
+	friend void windowSizeCallback(GLFWwindow* window, int width, int height);
+	friend void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
 	friend void framebufferResizeCallback(GLFWwindow* window, int width, int height);
 	friend void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Font.h"
 
 #include <fstream>
+#include <filesystem>
 
 using namespace nlohmann;
 
@@ -18,21 +19,56 @@ Font::Font(std::string const& fontInfoFilename)
 	cellHeight = fontInfo["cellHeight"];
 	charWidth = fontInfo["charWidth"];
 	charHeight = fontInfo["charHeight"];
+	distanceField = fontInfo.value("distanceField", false);
+	uint32_t distanceFieldScale = distanceField ? fontInfo.value("distanceFieldScale", 1U) : 0U;
+	float distanceFieldSpread = fontInfo.value("distanceFieldSpread", 0.0f);
+
+	std::filesystem::path bitmapPath{fontInfoFilename};
+	bitmapPath.replace_extension(".png");
+	if (fontInfo.contains("bitmap"))
+	{
+		bitmapPath.replace_filename(fontInfo["bitmap"].get<std::string>());
+	}
+	glyphCache = std::make_shared<GlyphCache>(bitmapPath.string(), (bitmapPath.parent_path() / "glyphs").string(), cellWidth, cellHeight, startChar,
+		GLYPH_CACHE_MEMORY_BUDGET, distanceFieldScale, distanceFieldSpread);
+}
+
+uint16_t Font::getCharGlyph(unsigned char c) const
+{
+	return glyphCache->getBaseGlyph(c);
+}
+
+uint16_t Font::acquireGlyph(char32_t codepoint) const
+{
+	return glyphCache->acquireGlyph(codepoint);
 }
 
-glm::vec2 Font::getCharOffset(unsigned char c) const
+void Font::releaseGlyph(uint16_t glyph) const
 {
-	c = std::max(c, startChar) - startChar;
-	uint32_t cellXCount = bitmapWidth / cellWidth;
-	uint32_t cellYCount = bitmapHeight / cellHeight;
-	float xOffset = (c % cellXCount) * (float)cellWidth / bitmapWidth;
-	float yOffset = (c / cellXCount) * (float)cellHeight / bitmapHeight;
-	return glm::vec2(xOffset, yOffset);
+	glyphCache->releaseGlyph(glyph);
 }
 
 glm::vec2 Font::getCharTextureScale() const
 {
-	float xScale = (float)charWidth / bitmapWidth;
-	float yScale = (float)charHeight / bitmapHeight;
+	float xScale = (float)charWidth / glyphCache->getWidth();
+	float yScale = (float)charHeight / glyphCache->getHeight();
 	return glm::vec2(xScale, yScale);
+}
+
+uint16_t Font::getAtlasGlyph() const
+{
+	return static_cast<uint16_t>(glyphCache->getGlyphCount());
+}
+
+std::vector<glm::vec4> Font::getGlyphTable() const
+{
+	std::vector<glm::vec4> table;
+	table.reserve(glyphCache->getGlyphCount() + 1);
+	auto textureScale = getCharTextureScale();
+	for (uint32_t glyph = 0; glyph < glyphCache->getGlyphCount(); glyph++)
+	{
+		table.emplace_back(glyphCache->getGlyphOffset(glyph), textureScale);
+	}
+	table.emplace_back(0.0f, 0.0f, 1.0f, 1.0f);
+	return table;
 }
\ No newline at end of file
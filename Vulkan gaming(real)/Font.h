@@ -1,16 +1,25 @@
 #pragma once
 
+#include <memory>
+#include <vector>
 #include <json.hpp>
 
 #include "constants.h"
+#include "GlyphCache.h"
 
 class Font
 {
 public:
 	Font(std::string const& fontInfoFilename);
 
-	glm::vec2 getCharOffset(unsigned char c) const;
+	uint16_t getCharGlyph(unsigned char c) const;
+	uint16_t acquireGlyph(char32_t codepoint) const;
+	void releaseGlyph(uint16_t glyph) const;
 	glm::vec2 getCharTextureScale() const;
+	//glyph table entry that covers the whole atlas
+	uint16_t getAtlasGlyph() const;
+	//atlas offset and scale of every glyph index, uploaded once since the index layout is fixed
+	std::vector<glm::vec4> getGlyphTable() const;
 
 	uint32_t bitmapWidth;
 	uint32_t bitmapHeight;
@@ -20,4 +29,7 @@ public:
 	uint32_t cellHeight;
 	uint32_t charWidth;
 	uint32_t charHeight;
+	bool distanceField;
+
+	std::shared_ptr<GlyphCache> glyphCache;
 };
\ No newline at end of file
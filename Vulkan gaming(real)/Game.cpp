@@ -1,53 +1,85 @@
 #include "Game.h"
 
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <random>
+
 #include "EventHandler.h"
+#include "Systems.h"
+#include "logging.h"
+
+static double getLoopTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-Game::Game()
-	:eventHandler(), debugFont{"textures/DejaVu mono.json"}, debugTextBox({0.0f, -1.0f, 0.0f}, {1.0f, 0.5f}, debugFont), gameOverFlash(debugFont),
-	mineMap{ 30, 15, 50, debugFont, {observer} }, resetButton({ -2.0f / 16.0f, -1.0f, -0.1f }, { 4.0f / 16.0f, 2.0f / 16.0f }, debugFont, "lmao"s,
-		MemberFunction(mineMap, &Map::reset)), remainingMines("Mines: "s + std::to_string(mineMap.getMineCount()), debugFont, {-1.0f, -0.925f, -0.1f}),
+Game::Game(GameOptions const& options)
+	:options(options), inputReplay(options.replayFilename.empty() ? nullptr : std::make_unique<InputReplay>(options.replayFilename)),
+	seed(inputReplay ? inputReplay->getSeed() : std::random_device{}()),
+	inputRecorder(options.recordFilename.empty() ? nullptr : std::make_unique<InputRecorder>(options.recordFilename, seed)),
+	eventHandler(), debugFont{USE_DISTANCE_FIELD_FONT ? "textures/DejaVu mono sdf.json" : "textures/DejaVu mono.json"}, debugTextBox({0.0f, -1.0f, 0.0f}, {1.0f, 0.5f}, debugFont),
+	performanceOverlay({0.0f, -0.85f, -0.2f}, {1.0f, 0.9f}, debugFont), systemThreads(std::thread::hardware_concurrency()), gameOverFlash(debugFont),
+	mineMap{ 30, 15, 50, debugFont, eventBus.getChannel<MapStateChanged>(), seed, options.infinite ? Map::Mode::eInfinite : Map::Mode::eBounded, options.noGuess }, resetButton({ -2.0f / 16.0f, -1.0f, -0.1f }, { 4.0f / 16.0f, 2.0f / 16.0f }, debugFont, "lmao"s,
+		MemberFunction(*this, &Game::resetMap)), remainingMines("Mines: "s + std::to_string(mineMap.getMineCount()), debugFont, {-1.0f, -0.925f, -0.1f}),
 	gameTimerText("0", debugFont, {0.75f, -0.925f, -0.1f})
 {
-	vulkan = std::make_unique<VulkanResources>(&eventHandler);
+	errorFatal(!options.headless || inputReplay, "headless mode needs an input recording to replay"s);
+	if (!options.headless)
+	{
+		vulkan = std::make_unique<VulkanResources>(&eventHandler, debugFont);
+		vulkan->setLateLatchCallback(MemberFunction(*this, &Game::lateLatchInput));
+		vulkan->setTileMap(mineMap.getTileMap());
+		vulkan->setCamera(mineMap.getCamera());
+		vulkan->setSystemThreads(&systemThreads);
+	}
+	if (inputReplay)
+	{
+		lateLatchEnabled = false;
+		eventHandler.setLiveInputEnabled(false);
+	}
+	mineMap.setActionListener([this](ActionJournal::Action const& action, ActionJournal::Change change) { onBoardAction(action, change); });
+	mineMap.setSystemThreads(&systemThreads);
+	startAutosave();
+	updateRemainingMines();
 
 	startLoop();
 }
 
 bool Game::gameShouldStop()
 {
-	return vulkan->windowCloseStatus();
+	return (vulkan && vulkan->windowCloseStatus()) || (inputReplay && inputReplay->isFinished(tickCount));
 }
 
 void Game::startLoop()
 {
-	double currentTime = glfwGetTime();
+	double currentTime = getLoopTime();
+	double startTime = currentTime;
 	double elapsedTime = 0.0;
-	double FPSTime = 0.0;
 	double deltaTime = 0.0;
 	double newTime = currentTime;
 
 	while (!gameShouldStop())
 	{
-		newTime = glfwGetTime();
+		newTime = getLoopTime();
 		deltaTime = newTime - currentTime;
 		elapsedTime += deltaTime;
-		FPSTime += deltaTime;
 		currentTime = newTime;
 		uint64_t updateCount = 0;
 
-		if (elapsedTime > TIME_STEP)
+		if (inputReplay && options.fastReplay)
 		{
-			eventHandler.pollEvents();
-			if (FPSTime > 1.0)
+			if (vulkan) eventHandler.pollEvents();
+			while (updateCount < REPLAY_FAST_TICKS_PER_FRAME && !inputReplay->isFinished(tickCount))
 			{
-				if (showFPSCounter)
-				{
-					updateFPSCounter();
-				}
-
-				FPSTime = std::fmod(FPSTime, 1.0);
-				FPSCount = 0;
+				update();
+				updateCount++;
 			}
+		}
+		else if (elapsedTime > TIME_STEP)
+		{
+			if (vulkan) eventHandler.pollEvents();
 
 			while (elapsedTime > TIME_STEP && updateCount < 4)
 			{
@@ -59,28 +91,29 @@ void Game::startLoop()
 			{
 				elapsedTime = 0.0;
 			}
-
-			updateCount = 0;
 		}
 
+		if (!vulkan) continue;
+
 		vulkan->drawFrame();
-		FPSCount++;
+		updateClickLatency();
+		auto const& frameStatistics = vulkan->getFrameStatistics();
+		performanceOverlay.record(PerformanceSample{deltaTime, updateCount, GameWorld::entities.getEntityCount(), frameStatistics.uploadedBytes,
+			frameStatistics.gpuTime, frameStatistics.gpuTimeAvailable, clickLatency});
 	}
 
-	vulkan->stopRendering();
+	if (vulkan) vulkan->stopRendering();
+	if (inputReplay) reportReplay(getLoopTime() - startTime);
 }
 
-void Game::onMouseButtonPressed(int button)
+void Game::onMouseButtonPressed(int button, double xPos, double yPos)
 {
 	switch (button)
 	{
 	case GLFW_MOUSE_BUTTON_RIGHT:
 	case GLFW_MOUSE_BUTTON_LEFT:
 	{
-		auto [xPos, yPos] = vulkan->getCursorCoordinates();
-		mineMap.onMousePressed(xPos, yPos, button == GLFW_MOUSE_BUTTON_LEFT);
-		if (button == GLFW_MOUSE_BUTTON_LEFT) resetButton.onMousePressed(xPos, yPos);
-		remainingMines.setText("Mines: " + std::to_string(mineMap.getMineCount() - mineMap.getMarkedCellCount()));
+		if (GameWorld::hitRegions.press({xPos, yPos}, button)) updateRemainingMines();
 		break;
 	}
 	default:
@@ -113,22 +146,49 @@ void Game::onKeyPressed(int key)
 	switch (key)
 	{
 	case GLFW_KEY_ESCAPE:
-		vulkan->setWindowShouldClose();
+		if (vulkan) vulkan->setWindowShouldClose();
 		break;
 	case GLFW_KEY_F2:
-		toggleFPSCounter();
-		debugTextBox.addText("Toggled FPS counter"s, 512ULL);
+		performanceOverlay.toggle();
+		debugTextBox.addText("Toggled performance overlay"s, 512ULL);
 		break;
 	case GLFW_KEY_F3:
-		vulkan->toggleWireframeMode();
+		if (vulkan) vulkan->toggleWireframeMode();
 		debugTextBox.addText("Toggled wireframe mode"s, 512ULL);
 		break;
+	case GLFW_KEY_F5:
+		lateLatchEnabled = !lateLatchEnabled;
+		debugTextBox.addText(lateLatchEnabled ? "Enabled late input latching"s : "Disabled late input latching"s, 512ULL);
+		break;
+	case GLFW_KEY_H:
+		showHint();
+		break;
+	case GLFW_KEY_F6:
+		autoPlayEnabled = !autoPlayEnabled;
+		debugTextBox.addText(autoPlayEnabled ? "Enabled auto-play"s : "Disabled auto-play"s, 512ULL);
+		break;
+	case GLFW_KEY_F7:
+		showWorkerStatistics();
+		break;
+	case GLFW_KEY_HOME:
+		mineMap.fitCamera();
+		break;
+	case GLFW_KEY_Z:
+		if (mineMap.undo()) updateRemainingMines();
+		break;
+	case GLFW_KEY_Y:
+		if (mineMap.redo()) updateRemainingMines();
+		break;
+	case GLFW_KEY_F9:
+		if (options.autosave) startAutosave();
+		else debugTextBox.addText(saveSnapshot() ? "Saved snapshot"s : "Couldn't save snapshot"s, 512ULL);
+		break;
+	case GLFW_KEY_F10:
+		loadSnapshot();
+		break;
 	case GLFW_KEY_F4:
-	{
-		uint64_t temp = 0;
-		ObjectPools::quads.add(QuadComponent({0.0f, 0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f}), &temp);
+		GameWorld::entities.create(Transform{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f}}, Tint{}, GlyphRegion{debugFont.getAtlasGlyph()});
 		break;
-	}
 	default:
 		break;
 	}
@@ -147,15 +207,17 @@ void Game::onMapStateChanged(Map::State newState)
 		resetButton.changeText("lmao"s);
 		gameTimer = 0;
 		gameTimerText.setText("0");
-		remainingMines.setText("Mines: "s + std::to_string(mineMap.getMineCount()));
+		updateRemainingMines();
 		break;
 	case Map::State::eLost:
 		resetButton.changeText("retard"s);
 		gameOverFlash.start({ 1.0f, 0.0f, 0.0f }, 0.1);
+		updateRemainingMines();
 		break;
 	case Map::State::eWon:
 		resetButton.changeText("based"s);
 		gameOverFlash.start({ 0.0f, 1.0f, 0.0f }, 0.1);
+		updateRemainingMines();
 		break;
 	case Map::State::ePlaying:
 		resetButton.changeText("yooo"s);
@@ -165,50 +227,285 @@ void Game::onMapStateChanged(Map::State newState)
 	}
 }
 
+void Game::onBoardAction(ActionJournal::Action const& action, ActionJournal::Change change)
+{
+	if (!autosaveWriter) return;
+
+	if (!autosaveWriter->append(action, change, SnapshotProgress{ static_cast<uint64_t>(mineMap.getCurrentState()), mineMap.getCoveredCellCount(),
+		mineMap.getMarkedCellCount(), gameTimer }))
+	{
+		autosaveWriter.reset();
+		debugTextBox.addText("Autosave stopped, couldn't write to the log"s, 512ULL);
+	}
+}
+
+void Game::resetMap()
+{
+	mineMap.reset();
+	startAutosave();
+}
+
+bool Game::saveSnapshot()
+{
+	SnapshotProgress progress{ static_cast<uint64_t>(mineMap.getCurrentState()), mineMap.getCoveredCellCount(), mineMap.getMarkedCellCount(), gameTimer };
+	return GameSnapshot::save(SNAPSHOT_FILE, mineMap.getBoard(), progress, mineMap.getBoardMetrics(), seed);
+}
+
+void Game::loadSnapshot()
+{
+	//the writer would otherwise append to a log that no longer matches the board
+	autosaveWriter.reset();
+
+	std::string error;
+	auto snapshot = GameSnapshot::open(SNAPSHOT_FILE, error);
+	if (!snapshot)
+	{
+		debugTextBox.addText("Couldn't load snapshot: "s + error, 512ULL);
+		return;
+	}
+
+	auto progress = snapshot->getProgress();
+	auto logEnd = snapshot->getLogEnd();
+	auto recordCount = snapshot->getRecords().size();
+	auto snapshotSeed = snapshot->getSeed();
+	if (!mineMap.loadSnapshot(std::move(snapshot)))
+	{
+		debugTextBox.addText("Snapshot doesn't fit this board"s, 512ULL);
+		return;
+	}
+	if (mineMap.getBoard().isSnapshotCorrupt())
+	{
+		discardCorruptSnapshot();
+		return;
+	}
+
+	seed = snapshotSeed;
+	gameTimer = progress.gameTimer;
+	gameTimerText.setText(std::to_string(std::roundf((float)gameTimer * 100.0f) / 100.0f));
+	updateRemainingMines();
+	debugTextBox.addText(std::format("Loaded snapshot with {} autosaved actions"sv, recordCount), 512ULL);
+	if (!options.autosave) return;
+
+	//the writer truncates the file, which Windows refuses while lazily decoded chunks keep it mapped
+	mineMap.getBoard().decodeAllChunks(&systemThreads);
+	if (mineMap.getBoard().isSnapshotCorrupt())
+	{
+		discardCorruptSnapshot();
+		return;
+	}
+	openAutosaveWriter(logEnd);
+}
+
+//chunks are only checked as they are decoded, so a corrupt one can turn up long after loading, the game is replaced rather than played on with covered holes
+void Game::discardCorruptSnapshot()
+{
+	debugTextBox.addText("Snapshot is corrupt, started a new board"s, 512ULL);
+	resetMap();
+}
+
+//the current board becomes the base of the log, done on every new board so the log only ever holds actions of one game
+void Game::startAutosave()
+{
+	autosaveWriter.reset();
+	if (!options.autosave || mineMap.isInfinite()) return;
+
+	if (!saveSnapshot())
+	{
+		debugTextBox.addText("Couldn't start autosave"s, 512ULL);
+		return;
+	}
+	openAutosaveWriter(std::filesystem::file_size(SNAPSHOT_FILE));
+}
+
+void Game::openAutosaveWriter(uint64_t logEnd)
+{
+	autosaveWriter = std::make_unique<AutosaveWriter>(SNAPSHOT_FILE, logEnd);
+	if (autosaveWriter->isOpen()) return;
+
+	autosaveWriter.reset();
+	debugTextBox.addText("Couldn't start autosave"s, 512ULL);
+}
+
 void Game::update()
 {
+	if (inputReplay) inputReplay->feedTick(tickCount, eventHandler);
 	processInput();
-	debugTextBox.update();
-	gameOverFlash.update();
-	for (auto&& notification : observer.getNotifications())
+	if (vulkan)
 	{
-		if (notification.first == NotifierType::eMap)
-		{
-			onMapStateChanged((Map::State)notification.second);
-		}
+		auto [xPos, yPos] = eventHandler.getCursorCoordinates();
+		GameWorld::hitRegions.hover({xPos, yPos});
 	}
+	updateCamera();
+	updateAutoPlay();
+	if (mineMap.getBoard().isSnapshotCorrupt()) discardCorruptSnapshot();
+	debugTextBox.update();
+	updateLifetimes(GameWorld::entities, TIME_STEP, &systemThreads);
+	gameOverFlash.update();
+	eventBus.drain<MapStateChanged>([&](MapStateChanged const& stateChange) { onMapStateChanged(stateChange.newState); });
 	if (mineMap.getCurrentState() == Map::State::ePlaying && mineMap.getCoveredCellCount() != mineMap.getCellCount() - mineMap.getMineCount())
 	{
 		gameTimer += TIME_STEP;
 		gameTimerText.setText(std::to_string(std::roundf((float)gameTimer * 100.0f) / 100.0f));
 	}
+	tickCount++;
 }
 
 void Game::processInput()
 {
-	vulkan->framebufferResized = eventHandler.getFramebufferResized();
-	for (auto key : eventHandler.getPressedKeys()) onKeyPressed(key);
-	for (auto key : eventHandler.getHeldKeys()) onKeyHeld(key);
-	for (auto button : eventHandler.getPressedMouseButtons()) onMouseButtonPressed(button);
-	for (auto button : eventHandler.getHeldMouseButtons()) onMouseButtonHeld(button);
-	for (auto button : eventHandler.getReleasedMouseButtons()) onMouseButtonReleased(button);
+	auto events = eventHandler.getEvents();
+	for (auto&& event : events)
+	{
+		switch (event.type)
+		{
+		case EventType::eKeyPress:
+			onKeyPressed(event.code);
+			break;
+		case EventType::eMouseButtonPress:
+			if (!pendingClickTime && !inputReplay) pendingClickTime = event.time;
+			onMouseButtonPressed(event.code, event.x, event.y);
+			break;
+		case EventType::eMouseButtonRelease:
+			onMouseButtonReleased(event.code);
+			break;
+		case EventType::eFramebufferResize:
+			if (vulkan) vulkan->framebufferResized = true;
+			break;
+		case EventType::eMouseScroll:
+			mineMap.zoomCamera(std::pow(CAMERA_ZOOM_STEP, static_cast<float>(event.code)), {event.x, event.y});
+			break;
+		default:
+			break;
+		}
+		if (inputRecorder) inputRecorder->record(tickCount, event);
+	}
+	eventHandler.consumeEvents(events);
+
+	auto const& heldKeys = eventHandler.getHeldKeys();
+	for (int key = 0; key < static_cast<int>(heldKeys.size()); key++)
+	{
+		if (heldKeys.test(key)) onKeyHeld(key);
+	}
+	auto const& heldMouseButtons = eventHandler.getHeldMouseButtons();
+	for (int button = 0; button < static_cast<int>(heldMouseButtons.size()); button++)
+	{
+		if (heldMouseButtons.test(button)) onMouseButtonHeld(button);
+	}
+}
+
+//panning runs once per tick from held keys so it stays frame rate independent and replays the same
+void Game::updateCamera()
+{
+	auto const& heldKeys = eventHandler.getHeldKeys();
+	glm::vec2 direction{0.0f, 0.0f};
+	if (heldKeys.test(GLFW_KEY_LEFT) || heldKeys.test(GLFW_KEY_A)) direction.x -= 1.0f;
+	if (heldKeys.test(GLFW_KEY_RIGHT) || heldKeys.test(GLFW_KEY_D)) direction.x += 1.0f;
+	if (heldKeys.test(GLFW_KEY_UP) || heldKeys.test(GLFW_KEY_W)) direction.y -= 1.0f;
+	if (heldKeys.test(GLFW_KEY_DOWN) || heldKeys.test(GLFW_KEY_S)) direction.y += 1.0f;
+	if (direction.x != 0.0f || direction.y != 0.0f) mineMap.panCamera(direction * CAMERA_PAN_SPEED * static_cast<float>(TIME_STEP));
 }
 
-void Game::updateFPSCounter()
+void Game::updateRemainingMines()
 {
-	FPSCounter = std::make_unique<Text>("FPS:"s + std::to_string(FPSCount), debugFont, glm::vec3(-1.0f, -1.0f, 0.0f));
+	auto state = mineMap.getCurrentState();
+	if (!mineMap.isInfinite() && (state == Map::State::eLost || state == Map::State::eWon))
+	{
+		//finished boards show their 3BV instead, and how many of those clicks per second a win took
+		auto bbbv = mineMap.getBoardMetrics().bbbv;
+		if (state == Map::State::eWon && gameTimer > 0.0) remainingMines.setText(std::format("3BV: {} {:.2f}/s"sv, bbbv, bbbv / gameTimer));
+		else remainingMines.setText("3BV: "s + std::to_string(bbbv));
+	}
+	else if (mineMap.isInfinite()) remainingMines.setText("Marks: "s + std::to_string(mineMap.getMarkedCellCount()));
+	else remainingMines.setText("Mines: "s + std::to_string(mineMap.getMineCount() - mineMap.getMarkedCellCount()));
 }
 
-void Game::toggleFPSCounter()
+void Game::showHint()
 {
-	if (!showFPSCounter)
+	auto input = mineMap.getSolverInput();
+	auto result = solver.solve(input);
+	if (!result.safeCells.empty())
 	{
-		showFPSCounter = true;
-		updateFPSCounter();
+		auto [x, y] = mineMap.getSolverCellCoordinates(result.safeCells.front());
+		debugTextBox.addText(std::format("Hint: {}, {} is safe, {} safe cells known"sv, x, y, result.safeCells.size()), 512ULL);
+		return;
 	}
-	else
+
+	std::size_t guess = SIZE_MAX;
+	for (std::size_t i = 0; i < input.cells.size(); i++)
 	{
-		showFPSCounter = false;
-		FPSCounter.reset(nullptr);
+		if (input.cells[i] == SolverInput::COVERED && (guess == SIZE_MAX || result.mineProbabilities[i] < result.mineProbabilities[guess])) guess = i;
 	}
+	if (guess == SIZE_MAX) return;
+	auto [x, y] = mineMap.getSolverCellCoordinates(guess);
+	debugTextBox.addText(std::format("Hint: no safe cell, best guess {}, {} with {:.0f}% mine chance"sv, x, y, result.mineProbabilities[guess] * 100.0f), 512ULL);
 }
+
+//prints how busy each system worker was and how many jobs it stole since the last call
+void Game::showWorkerStatistics()
+{
+	auto statistics = systemThreads.getWorkerStatistics();
+	for (std::size_t i = 0; i < statistics.size(); i++)
+	{
+		debugTextBox.addText(std::format("Worker {}: {:.1f}% busy, {} jobs, {} stolen"sv, i, statistics[i].utilisation * 100.0, statistics[i].executedJobs,
+			statistics[i].stolenJobs), 512ULL);
+	}
+	systemThreads.resetWorkerStatistics();
+}
+
+//runs every SOLVER_AUTOPLAY_INTERVAL ticks, marks certain mines and opens certain safe cells, guesses the least likely mine when stuck
+void Game::updateAutoPlay()
+{
+	if (!autoPlayEnabled || tickCount % SOLVER_AUTOPLAY_INTERVAL != 0) return;
+
+	auto state = mineMap.getCurrentState();
+	if (state == Map::State::eLost || state == Map::State::eWon)
+	{
+		resetMap();
+		return;
+	}
+
+	auto input = mineMap.getSolverInput();
+	auto result = solver.solve(input);
+	for (auto cell : result.mineCells)
+	{
+		if (input.cells[cell] == SolverInput::COVERED) mineMap.markSolverCell(cell);
+	}
+	for (auto cell : result.safeCells)
+	{
+		mineMap.pressSolverCell(cell);
+	}
+	if (result.safeCells.empty())
+	{
+		std::size_t guess = SIZE_MAX;
+		for (std::size_t i = 0; i < input.cells.size(); i++)
+		{
+			if (input.cells[i] == SolverInput::COVERED && (guess == SIZE_MAX || result.mineProbabilities[i] < result.mineProbabilities[guess])) guess = i;
+		}
+		if (guess != SIZE_MAX) mineMap.pressSolverCell(guess);
+	}
+	updateRemainingMines();
+}
+
+void Game::reportReplay(double replayTime)
+{
+	formatPrint(std::cout, "Replayed {} ticks in {:.3f} s, {:.0f} ticks/s, seed {}, final state {}, {} covered cells, {} marked cells\n"sv, tickCount, replayTime,
+		tickCount / std::max(replayTime, 1e-9), seed, static_cast<size_t>(mineMap.getCurrentState()), mineMap.getCoveredCellCount(), mineMap.getMarkedCellCount());
+}
+
+//runs inside drawFrame after the frame fence so input that arrived while waiting still makes it into this frame's instance upload
+void Game::lateLatchInput()
+{
+	if (!lateLatchEnabled) return;
+
+	eventHandler.pollEvents();
+	processInput();
+}
+
+void Game::updateClickLatency()
+{
+	auto submitTime = vulkan->getFrameStatistics().submitTime;
+	if (pendingClickTime && submitTime >= *pendingClickTime)
+	{
+		clickLatency = submitTime - *pendingClickTime;
+		pendingClickTime.reset();
+	}
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "VulkanResources.h"
 #include "EventHandler.h"
@@ -8,20 +9,34 @@
 #include "Map.h"
 #include "Button.h"
 #include "GraphicalEffects.h"
-#include "Observer.h"
+#include "EventBus.h"
+#include "PerformanceOverlay.h"
+#include "InputRecording.h"
 
 class EventHandler;
 
+struct GameOptions
+{
+	std::string recordFilename;
+	std::string replayFilename;
+	bool headless = false;
+	bool fastReplay = false;
+	bool infinite = false;
+	bool noGuess = false;
+	//keeps SNAPSHOT_FILE current by appending every board action to the snapshot of the board it started from
+	bool autosave = false;
+};
+
 class Game
 {
 public:
-	Game();
+	explicit Game(GameOptions const& options = {});
 
 private:
 	bool gameShouldStop();
 	void startLoop();
 
-	void onMouseButtonPressed(int button);
+	void onMouseButtonPressed(int button, double xPos, double yPos);
 	void onMouseButtonHeld(int button);
 	void onMouseButtonReleased(int button);
 
@@ -29,28 +44,53 @@ private:
 	void onKeyHeld(int key);
 
 	void onMapStateChanged(Map::State newState);
+	void onBoardAction(ActionJournal::Action const& action, ActionJournal::Change change);
+
+	void resetMap();
+	bool saveSnapshot();
+	void loadSnapshot();
+	void discardCorruptSnapshot();
+	void startAutosave();
+	void openAutosaveWriter(uint64_t logEnd);
 
 	void update();
 	void processInput();
-
-	bool showFPSCounter = false;
-	uint64_t FPSCount = 0;
-	std::unique_ptr<Text> FPSCounter;
-	void updateFPSCounter();
-	void toggleFPSCounter();
+	void updateCamera();
+	void updateRemainingMines();
+	void showHint();
+	void showWorkerStatistics();
+	void updateAutoPlay();
+	void reportReplay(double replayTime);
+	void lateLatchInput();
+	void updateClickLatency();
+
+	GameOptions options;
+	std::unique_ptr<InputReplay> inputReplay;
+	uint32_t seed;
+	std::unique_ptr<InputRecorder> inputRecorder;
+	uint64_t tickCount{};
 
 	Font debugFont;
 	TextBox debugTextBox;
+	PerformanceOverlay performanceOverlay;
 
+	//runs the entity systems, declared before vulkan so it outlives the renderer using it
+	ThreadPool systemThreads;
 	std::unique_ptr<VulkanResources> vulkan;
+	bool lateLatchEnabled = LATE_LATCH_INPUT;
+	std::optional<double> pendingClickTime;
+	double clickLatency{};
 
 	EventHandler eventHandler;
 
 	ColorFlash gameOverFlash;
 
-	Observer observer;
+	EventBus<Concurrent<MapStateChanged>> eventBus;
 	Map mineMap;
-	Button<MemberFunction<void, Map>> resetButton;
+	Solver solver;
+	bool autoPlayEnabled = false;
+	Button<MemberFunction<void, Game>> resetButton;
+	std::unique_ptr<AutosaveWriter> autosaveWriter;
 
 	Text remainingMines;
 	double gameTimer{};
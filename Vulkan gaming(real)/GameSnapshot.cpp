@@ -0,0 +1,297 @@
+#include "GameSnapshot.h"
+
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Board.h"
+#include "helpers.h"
+
+struct SnapshotHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t width;
+	uint64_t height;
+	uint64_t mineCount;
+	uint64_t chunkCount;
+	uint64_t cellOffset;
+	SnapshotProgress progress;
+	BoardMetrics metrics;
+	uint32_t seed;
+	uint32_t reserved;
+	uint64_t tableChecksum;
+	uint64_t headerChecksum;
+};
+
+struct RecordHeader
+{
+	uint64_t payloadSize;
+	uint64_t checksum;
+};
+
+struct RecordPayload
+{
+	SnapshotProgress progress;
+	uint64_t cellCount;
+	uint8_t from;
+	uint8_t to;
+	uint8_t stateBefore;
+	uint8_t stateAfter;
+	uint8_t change;
+	uint8_t reserved[3];
+};
+
+static_assert(ChunkedGrid<uint8_t>::CHUNK_AREA == GameSnapshot::PAGE_SIZE, "a chunk of cells has to fill exactly one page");
+
+//a word at a time so checking a chunk costs about as much as reading it
+static uint64_t checksumBytes(uint8_t const* data, std::size_t size)
+{
+	uint64_t checksum = mixBits(size);
+	std::size_t offset = 0;
+	for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, data + offset, sizeof(word));
+		checksum = mixBits(checksum ^ word);
+	}
+	uint64_t tail = 0;
+	std::memcpy(&tail, data + offset, size - offset);
+	return mixBits(checksum ^ tail);
+}
+
+//adjacent mines in the low nibble, then the mine bit, then two bits of state
+static uint8_t encodeCell(BoardLayout::Cell const& cell)
+{
+	return static_cast<uint8_t>(cell.adjacentMines | (cell.mined ? 0x10 : 0) | (static_cast<uint8_t>(cell.state) << 5));
+}
+
+static BoardLayout::Cell decodeCell(uint8_t byte)
+{
+	return { (byte & 0x10) != 0, static_cast<uint8_t>(byte & 0x0F), static_cast<BoardLayout::CellState>(byte >> 5) };
+}
+
+MappedFile::MappedFile(std::string const& filename)
+{
+#ifdef _WIN32
+	auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+	mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) return;
+
+	data = static_cast<uint8_t const*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (data) size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0) return;
+
+	struct stat fileStatus{};
+	if (fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+	{
+		auto mapping = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping != MAP_FAILED)
+		{
+			data = static_cast<uint8_t const*>(mapping);
+			size = static_cast<std::size_t>(fileStatus.st_size);
+		}
+	}
+	//the mapping keeps the file referenced on its own
+	::close(file);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+#else
+	if (data) munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
+std::unique_ptr<GameSnapshot> GameSnapshot::open(std::string const& filename, std::string& error)
+{
+	auto file = std::make_unique<MappedFile>(filename);
+	if (!file->isOpen())
+	{
+		error = "couldn't map "s + filename;
+		return nullptr;
+	}
+
+	SnapshotHeader header;
+	if (file->getSize() < sizeof(header))
+	{
+		error = "file is too short"s;
+		return nullptr;
+	}
+	std::memcpy(&header, file->getData(), sizeof(header));
+	if (header.magic != MAGIC)
+	{
+		error = "not a snapshot"s;
+		return nullptr;
+	}
+	if (header.version != VERSION)
+	{
+		error = "unsupported version "s + std::to_string(header.version);
+		return nullptr;
+	}
+	if (header.headerChecksum != checksumBytes(file->getData(), offsetof(SnapshotHeader, headerChecksum)))
+	{
+		error = "header checksum mismatch"s;
+		return nullptr;
+	}
+
+	std::size_t chunkCountX = (header.width + BOARD_CHUNK_SIZE - 1) / BOARD_CHUNK_SIZE;
+	std::size_t chunkCountY = (header.height + BOARD_CHUNK_SIZE - 1) / BOARD_CHUNK_SIZE;
+	std::size_t cellEnd = header.cellOffset + header.chunkCount * ChunkedGrid<uint8_t>::CHUNK_AREA;
+	if (header.chunkCount != chunkCountX * chunkCountY || header.cellOffset < sizeof(header) + header.chunkCount * sizeof(uint64_t) ||
+		header.cellOffset % PAGE_SIZE != 0 || cellEnd > file->getSize())
+	{
+		error = "cells don't fit the file"s;
+		return nullptr;
+	}
+	auto table = file->getData() + sizeof(header);
+	if (header.tableChecksum != checksumBytes(table, header.chunkCount * sizeof(uint64_t)))
+	{
+		error = "chunk table checksum mismatch"s;
+		return nullptr;
+	}
+
+	std::unique_ptr<GameSnapshot> snapshot{ new GameSnapshot(std::move(file)) };
+	snapshot->width = header.width;
+	snapshot->height = header.height;
+	snapshot->mineCount = header.mineCount;
+	snapshot->chunkCount = header.chunkCount;
+	snapshot->seed = header.seed;
+	snapshot->metrics = header.metrics;
+	snapshot->baseProgress = header.progress;
+	snapshot->chunkChecksums = reinterpret_cast<uint64_t const*>(table);
+	snapshot->cellData = snapshot->file->getData() + header.cellOffset;
+
+	//only the tail of the file past the cells is read here
+	auto data = snapshot->file->getData();
+	auto offset = cellEnd;
+	while (offset + sizeof(RecordHeader) + sizeof(RecordPayload) <= snapshot->file->getSize())
+	{
+		RecordHeader recordHeader;
+		std::memcpy(&recordHeader, data + offset, sizeof(recordHeader));
+		auto payload = data + offset + sizeof(recordHeader);
+		if (recordHeader.payloadSize < sizeof(RecordPayload) || recordHeader.payloadSize > snapshot->file->getSize() - offset - sizeof(recordHeader) ||
+			recordHeader.checksum != checksumBytes(payload, recordHeader.payloadSize)) break;
+
+		RecordPayload fields;
+		std::memcpy(&fields, payload, sizeof(fields));
+		Record record{ { static_cast<BoardLayout::CellState>(fields.from), static_cast<BoardLayout::CellState>(fields.to), fields.stateBefore, fields.stateAfter,
+			fields.cellCount, std::vector<uint8_t>(payload + sizeof(fields), payload + recordHeader.payloadSize) }, static_cast<ActionJournal::Change>(fields.change),
+			fields.progress };
+		//a record that passes its checksum but doesn't describe this board ends the log like a corrupt one, replaying it would write outside the cells
+		if (fields.from > static_cast<uint8_t>(BoardLayout::CellState::eMarked) || fields.to > static_cast<uint8_t>(BoardLayout::CellState::eMarked) ||
+			fields.change > static_cast<uint8_t>(ActionJournal::Change::eRedone) || !ActionJournal::fitsBoard(record.action, header.width, header.height)) break;
+		snapshot->records.push_back(std::move(record));
+		offset += sizeof(recordHeader) + recordHeader.payloadSize;
+	}
+	snapshot->logEnd = offset;
+	return snapshot;
+}
+
+bool GameSnapshot::save(std::string const& filename, Board& board, SnapshotProgress const& progress, BoardMetrics const& metrics, uint32_t seed)
+{
+	if (board.getMode() != Board::Mode::eBounded) return false;
+
+	//a board with holes from a corrupt snapshot would be saved as if it were whole
+	board.decodeAllChunks();
+	if (board.isSnapshotCorrupt()) return false;
+	auto const& cells = board.getCells();
+
+	auto chunkCount = cells.getChunkCount();
+	auto cellOffset = (sizeof(SnapshotHeader) + chunkCount * sizeof(uint64_t) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+	SnapshotHeader header{ MAGIC, VERSION, board.getWidth(), board.getHeight(), board.getMineCount(), chunkCount, cellOffset, progress, metrics, seed, 0, 0, 0 };
+
+	//written next to the target and renamed over it, a crash while saving leaves the previous save intact
+	auto temporaryFilename = filename + ".tmp"s;
+	{
+		std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+
+		std::vector<uint64_t> checksums(header.chunkCount);
+		std::vector<uint8_t> chunkBytes(ChunkedGrid<uint8_t>::CHUNK_AREA);
+		file.seekp(static_cast<std::streamoff>(header.cellOffset));
+		for (std::size_t chunk = 0; chunk < header.chunkCount; chunk++)
+		{
+			auto chunkCells = cells.getChunkData(chunk);
+			for (std::size_t i = 0; i < chunkBytes.size(); i++)
+			{
+				chunkBytes[i] = encodeCell(chunkCells[i]);
+			}
+			checksums[chunk] = checksumBytes(chunkBytes.data(), chunkBytes.size());
+			file.write(reinterpret_cast<char const*>(chunkBytes.data()), static_cast<std::streamsize>(chunkBytes.size()));
+		}
+
+		header.tableChecksum = checksumBytes(reinterpret_cast<uint8_t const*>(checksums.data()), checksums.size() * sizeof(uint64_t));
+		header.headerChecksum = checksumBytes(reinterpret_cast<uint8_t const*>(&header), offsetof(SnapshotHeader, headerChecksum));
+		file.seekp(0);
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		file.write(reinterpret_cast<char const*>(checksums.data()), static_cast<std::streamsize>(checksums.size() * sizeof(uint64_t)));
+		if (!file) return false;
+	}
+
+	std::error_code renameError;
+	std::filesystem::rename(temporaryFilename, filename, renameError);
+	return !renameError;
+}
+
+bool GameSnapshot::decodeChunk(std::size_t chunk, BoardLayout::Cell* cells) const
+{
+	auto bytes = cellData + chunk * ChunkedGrid<uint8_t>::CHUNK_AREA;
+	if (chunkChecksums[chunk] != checksumBytes(bytes, ChunkedGrid<uint8_t>::CHUNK_AREA)) return false;
+
+	for (std::size_t i = 0; i < ChunkedGrid<uint8_t>::CHUNK_AREA; i++)
+	{
+		cells[i] = decodeCell(bytes[i]);
+	}
+	return true;
+}
+
+AutosaveWriter::AutosaveWriter(std::string const& filename, uint64_t logEnd)
+{
+	//a torn record left past shorter new ones would be read back as part of the log
+	std::error_code resizeError;
+	std::filesystem::resize_file(filename, logEnd, resizeError);
+	if (resizeError) return;
+
+	file.open(filename, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekp(static_cast<std::streamoff>(logEnd));
+}
+
+bool AutosaveWriter::append(ActionJournal::Action const& action, ActionJournal::Change change, SnapshotProgress const& progress)
+{
+	if (!isOpen()) return false;
+
+	RecordPayload fields{ progress, action.cellCount, static_cast<uint8_t>(action.from), static_cast<uint8_t>(action.to), action.stateBefore, action.stateAfter,
+		static_cast<uint8_t>(change), {} };
+	buffer.resize(sizeof(fields));
+	std::memcpy(buffer.data(), &fields, sizeof(fields));
+	buffer.insert(buffer.end(), action.encodedCells.begin(), action.encodedCells.end());
+
+	RecordHeader header{ buffer.size(), checksumBytes(buffer.data(), buffer.size()) };
+	file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	file.flush();
+	return bool(file);
+}
\ No newline at end of file
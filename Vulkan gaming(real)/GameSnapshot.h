@@ -0,0 +1,117 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gameConstants.h"
+#include "ActionJournal.h"
+#include "BoardAnalysis.h"
+#include "BoardGenerator.h"
+
+class Board;
+
+//read-only mapping of a whole file, its pages are only read from disk once they are touched
+class MappedFile
+{
+public:
+	explicit MappedFile(std::string const& filename);
+	~MappedFile();
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	bool isOpen() const { return data != nullptr; }
+	uint8_t const* getData() const { return data; }
+	std::size_t getSize() const { return size; }
+
+private:
+	uint8_t const* data = nullptr;
+	std::size_t size{};
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+//everything about a game that is not in its cells
+struct SnapshotProgress
+{
+	uint64_t state{};
+	uint64_t coveredCellCount{};
+	uint64_t markedCellCount{};
+	double gameTimer{};
+};
+
+//versioned save of a bounded board: a header, one checksum per chunk, then the cells chunk by chunk in ChunkedGrid order, one byte each
+//the cells start page aligned and a chunk is exactly one page, so decoding a chunk through the mapping reads one page from disk
+//an autosave appends one record per journal action after the cells, the log ends at the first torn or corrupt record
+class GameSnapshot
+{
+public:
+	//"MSNP" in the first four bytes
+	static constexpr uint32_t MAGIC = 0x504E534D;
+	static constexpr uint32_t VERSION = 1;
+	static constexpr std::size_t PAGE_SIZE = 4096;
+
+	struct Record
+	{
+		ActionJournal::Action action;
+		ActionJournal::Change change;
+		SnapshotProgress progress;
+	};
+
+public:
+	//checks the header, the chunk checksums table and the record log, the cells themselves are only checked as they are decoded
+	static std::unique_ptr<GameSnapshot> open(std::string const& filename, std::string& error);
+	//only for bounded boards, a board still backed by a snapshot decodes all of its chunks first
+	static bool save(std::string const& filename, Board& board, SnapshotProgress const& progress, BoardMetrics const& metrics, uint32_t seed);
+
+	//fills a whole chunk of cells, false if the chunk fails its checksum
+	bool decodeChunk(std::size_t chunk, BoardLayout::Cell* cells) const;
+
+	std::size_t getWidth() const { return width; }
+	std::size_t getHeight() const { return height; }
+	std::size_t getMineCount() const { return mineCount; }
+	std::size_t getChunkCount() const { return chunkCount; }
+	uint32_t getSeed() const { return seed; }
+	BoardMetrics const& getMetrics() const { return metrics; }
+	//progress when the cells were written, and after the last record of the log
+	SnapshotProgress const& getBaseProgress() const { return baseProgress; }
+	SnapshotProgress const& getProgress() const { return records.empty() ? baseProgress : records.back().progress; }
+	std::vector<Record> const& getRecords() const { return records; }
+	//where the next record goes, past any torn record so the log stays readable
+	uint64_t getLogEnd() const { return logEnd; }
+
+private:
+	explicit GameSnapshot(std::unique_ptr<MappedFile> file) :file(std::move(file)) {}
+
+	std::unique_ptr<MappedFile> file;
+	std::size_t width{};
+	std::size_t height{};
+	std::size_t mineCount{};
+	std::size_t chunkCount{};
+	uint32_t seed{};
+	BoardMetrics metrics;
+	SnapshotProgress baseProgress;
+	uint64_t const* chunkChecksums = nullptr;
+	uint8_t const* cellData = nullptr;
+	std::vector<Record> records;
+	uint64_t logEnd{};
+};
+
+//appends records to the log of a snapshot file, every record is flushed right away so a crash loses at most the action in flight
+class AutosaveWriter
+{
+public:
+	//logEnd cuts off whatever follows the last valid record, the file must not be mapped any more or Windows refuses to shrink it
+	AutosaveWriter(std::string const& filename, uint64_t logEnd);
+
+	bool isOpen() const { return file.is_open() && bool(file); }
+	//false once a record couldn't be written, nothing after it reaches the log
+	bool append(ActionJournal::Action const& action, ActionJournal::Change change, SnapshotProgress const& progress);
+
+private:
+	std::fstream file;
+	std::vector<uint8_t> buffer;
+};
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "GlyphCache.h"
+
+#include <cstring>
+#include <stb_image.h>
+
+#include "DistanceField.h"
+#include "helpers.h"
+#include "logging.h"
+
+static constexpr uint32_t NO_PAGE = std::numeric_limits<uint32_t>::max();
+
+GlyphCache::GlyphCache(std::string const& bitmapFilename, std::string const& glyphDirectory, uint32_t cellWidth, uint32_t cellHeight, uint8_t startChar,
+	uint64_t memoryBudget, uint32_t distanceFieldScale, float distanceFieldSpread)
+	:glyphDirectory(glyphDirectory), cellWidth(cellWidth), cellHeight(cellHeight), startChar(startChar), distanceFieldScale(distanceFieldScale),
+	distanceFieldSpread(distanceFieldSpread), bytesPerPixel(distanceFieldScale > 0 ? 1 : 4)
+{
+	int bitmapWidth{}, bitmapHeight{}, bitmapChannels{};
+	stbi_uc* bitmap = stbi_load(bitmapFilename.c_str(), &bitmapWidth, &bitmapHeight, &bitmapChannels, static_cast<int>(bytesPerPixel));
+	errorFatal(bitmap != nullptr, "couldn't load font bitmap: "s + bitmapFilename);
+
+	width = static_cast<uint32_t>(bitmapWidth);
+	baseHeight = static_cast<uint32_t>(bitmapHeight);
+	pageHeight = cellHeight * GLYPH_PAGE_ROWS;
+	slotsPerPage = width / cellWidth * GLYPH_PAGE_ROWS;
+	maxPageCount = std::max<uint64_t>(memoryBudget / (uint64_t(width) * pageHeight * bytesPerPixel), 1);
+	height = baseHeight + pageHeight * static_cast<uint32_t>(maxPageCount);
+	baseGlyphCount = 256U - startChar;
+	errorFatal(getGlyphCount() < std::numeric_limits<uint16_t>::max(), "glyph cache has more slots than 16 bit glyph indices can name"s);
+
+	pixels.resize(std::size_t(width) * height * bytesPerPixel);
+	std::memcpy(pixels.data(), bitmap, std::size_t(width) * baseHeight * bytesPerPixel);
+	stbi_image_free(bitmap);
+
+	pages.reserve(maxPageCount);
+}
+
+uint16_t GlyphCache::getBaseGlyph(unsigned char c) const
+{
+	return static_cast<uint16_t>(std::max(c, startChar) - startChar);
+}
+
+glm::vec2 GlyphCache::getGlyphOffset(uint32_t glyph) const
+{
+	if (glyph < baseGlyphCount)
+	{
+		uint32_t cellXCount = width / cellWidth;
+		float xOffset = (glyph % cellXCount) * (float)cellWidth / width;
+		float yOffset = (glyph / cellXCount) * (float)cellHeight / height;
+		return glm::vec2(xOffset, yOffset);
+	}
+
+	glyph -= baseGlyphCount;
+	auto region = getSlotRegion(glyph / slotsPerPage, glyph % slotsPerPage);
+	return glm::vec2((float)region.x / width, (float)region.y / height);
+}
+
+uint16_t GlyphCache::acquireGlyph(char32_t codepoint)
+{
+	if (isBaseGlyph(codepoint)) return getBaseGlyph(static_cast<unsigned char>(codepoint));
+
+	if (auto found = glyphs.find(codepoint); found != glyphs.end())
+	{
+		auto& glyph = found->second;
+		glyph.references++;
+		pages[glyph.page].references++;
+		touchPage(glyph.page);
+		return getPageGlyph(glyph.page, glyph.slot);
+	}
+	if (missingGlyphs.contains(codepoint)) return getBaseGlyph('?');
+
+	auto [page, slot] = allocateSlot();
+	if (page == NO_PAGE) return getBaseGlyph('?');
+	if (!loadGlyph(codepoint, page, slot))
+	{
+		missingGlyphs.insert(codepoint);
+		return getBaseGlyph('?');
+	}
+
+	pages[page].slots[slot] = codepoint;
+	pages[page].usedSlots++;
+	pages[page].references++;
+	touchPage(page);
+
+	glyphs.emplace(codepoint, Glyph{page, slot, 1});
+	return getPageGlyph(page, slot);
+}
+
+void GlyphCache::releaseGlyph(uint16_t glyph)
+{
+	if (glyph < baseGlyphCount) return;
+
+	//a referenced page is never evicted, so the slot still holds the codepoint the reference was taken for
+	uint32_t page = (glyph - baseGlyphCount) / slotsPerPage;
+	uint32_t slot = (glyph - baseGlyphCount) % slotsPerPage;
+	if (page >= pages.size()) return;
+	auto found = glyphs.find(pages[page].slots[slot]);
+	if (found == glyphs.end() || found->second.page != page || found->second.slot != slot || found->second.references == 0) return;
+
+	found->second.references--;
+	pages[found->second.page].references--;
+}
+
+void GlyphCache::clearDirtyRegions(std::size_t count)
+{
+	dirtyRegions.erase(dirtyRegions.begin(), dirtyRegions.begin() + std::min(count, dirtyRegions.size()));
+}
+
+bool GlyphCache::loadGlyph(char32_t codepoint, uint32_t page, uint32_t slot)
+{
+	auto filename = std::format("{}/U+{:04X}.png"sv, glyphDirectory, static_cast<uint32_t>(codepoint));
+	int glyphWidth{}, glyphHeight{}, glyphChannels{};
+	stbi_uc* glyphPixels = stbi_load(filename.c_str(), &glyphWidth, &glyphHeight, &glyphChannels, STBI_rgb_alpha);
+	if (glyphPixels == nullptr) return false;
+
+	auto region = getSlotRegion(page, slot);
+	if (isDistanceField())
+	{
+		uint32_t fieldWidth = std::min(static_cast<uint32_t>(glyphWidth) / distanceFieldScale, region.width);
+		uint32_t fieldHeight = std::min(static_cast<uint32_t>(glyphHeight) / distanceFieldScale, region.height);
+		for (uint32_t row = 0; row < region.height; row++)
+		{
+			std::memset(pixels.data() + std::size_t(region.y + row) * width + region.x, 0, region.width);
+		}
+		generateDistanceField(glyphPixels, static_cast<uint32_t>(glyphWidth), static_cast<uint32_t>(glyphHeight), static_cast<uint32_t>(glyphWidth), 4,
+			pixels.data() + std::size_t(region.y) * width + region.x, fieldWidth, fieldHeight, width, distanceFieldScale, distanceFieldSpread);
+	}
+	else
+	{
+		uint32_t copyWidth = std::min(static_cast<uint32_t>(glyphWidth), region.width);
+		for (uint32_t row = 0; row < region.height; row++)
+		{
+			auto target = pixels.data() + (std::size_t(region.y + row) * width + region.x) * 4;
+			std::memset(target, 0, std::size_t(region.width) * 4);
+			if (row < static_cast<uint32_t>(glyphHeight))
+			{
+				std::memcpy(target, glyphPixels + std::size_t(row) * glyphWidth * 4, std::size_t(copyWidth) * 4);
+			}
+		}
+	}
+	stbi_image_free(glyphPixels);
+
+	dirtyRegions.push_back(region);
+	return true;
+}
+
+std::pair<uint32_t, uint32_t> GlyphCache::allocateSlot()
+{
+	for (auto page : lruPages)
+	{
+		if (pages[page].usedSlots < slotsPerPage)
+		{
+			auto freeSlot = std::find(pages[page].slots.begin(), pages[page].slots.end(), char32_t{0});
+			return {page, static_cast<uint32_t>(freeSlot - pages[page].slots.begin())};
+		}
+	}
+
+	if (pages.size() < maxPageCount)
+	{
+		auto page = static_cast<uint32_t>(pages.size());
+		pages.push_back(Page{std::vector<char32_t>(slotsPerPage, 0)});
+		lruPages.push_front(page);
+		pages[page].lruPosition = lruPages.begin();
+		return {page, 0};
+	}
+
+	for (auto it = lruPages.rbegin(); it != lruPages.rend(); it++)
+	{
+		if (pages[*it].references == 0)
+		{
+			evictPage(*it);
+			return {*it, 0};
+		}
+	}
+
+	return {NO_PAGE, 0};
+}
+
+void GlyphCache::evictPage(uint32_t page)
+{
+	for (auto& codepoint : pages[page].slots)
+	{
+		if (codepoint != 0) glyphs.erase(codepoint);
+		codepoint = 0;
+	}
+	pages[page].usedSlots = 0;
+}
+
+void GlyphCache::touchPage(uint32_t page)
+{
+	lruPages.splice(lruPages.begin(), lruPages, pages[page].lruPosition);
+}
+
+AtlasRegion GlyphCache::getSlotRegion(uint32_t page, uint32_t slot) const
+{
+	uint32_t columns = width / cellWidth;
+	return {slot % columns * cellWidth, baseHeight + page * pageHeight + slot / columns * cellHeight, cellWidth, cellHeight};
+}
\ No newline at end of file
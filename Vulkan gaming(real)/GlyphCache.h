@@ -0,0 +1,89 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "constants.h"
+
+struct AtlasRegion
+{
+	uint32_t x, y, width, height;
+};
+
+//font atlas made of the fixed base grid plus pages of glyphs loaded on demand, either RGBA or a single channel distance field
+//pages are evicted least recently used once the memory budget is reached, pages with referenced glyphs are never evicted
+//glyphs are named by 16 bit indices, the base glyphs come first and every page slot after them, so the layout of the index space never changes
+class GlyphCache
+{
+	struct Page
+	{
+		std::vector<char32_t> slots{};
+		uint32_t usedSlots{};
+		uint64_t references{};
+		std::list<uint32_t>::iterator lruPosition{};
+	};
+	struct Glyph
+	{
+		uint32_t page;
+		uint32_t slot;
+		uint64_t references;
+	};
+
+public:
+	GlyphCache(std::string const& bitmapFilename, std::string const& glyphDirectory, uint32_t cellWidth, uint32_t cellHeight, uint8_t startChar,
+		uint64_t memoryBudget, uint32_t distanceFieldScale = 0, float distanceFieldSpread = 0.0f);
+
+	uint16_t getBaseGlyph(unsigned char c) const;
+	//takes a reference only when it returns a page glyph, the base glyphs and the '?' fallback need none
+	uint16_t acquireGlyph(char32_t codepoint);
+	//takes the index acquireGlyph returned, so only references that were actually taken are given back
+	void releaseGlyph(uint16_t glyph);
+	uint32_t getGlyphCount() const { return baseGlyphCount + static_cast<uint32_t>(maxPageCount) * slotsPerPage; }
+	glm::vec2 getGlyphOffset(uint32_t glyph) const;
+
+	uint32_t getWidth() const { return width; }
+	uint32_t getHeight() const { return height; }
+	uint32_t getBytesPerPixel() const { return bytesPerPixel; }
+	bool isDistanceField() const { return distanceFieldScale > 0; }
+	uint8_t const* getPixels() const { return pixels.data(); }
+	std::size_t getPageCount() const { return pages.size(); }
+	std::size_t getMaxPageCount() const { return maxPageCount; }
+
+	std::vector<AtlasRegion> const& getDirtyRegions() const { return dirtyRegions; }
+	void clearDirtyRegions(std::size_t count);
+
+private:
+	bool isBaseGlyph(char32_t codepoint) const { return codepoint <= 0xFF; }
+	bool loadGlyph(char32_t codepoint, uint32_t page, uint32_t slot);
+	std::pair<uint32_t, uint32_t> allocateSlot();
+	void evictPage(uint32_t page);
+	void touchPage(uint32_t page);
+	AtlasRegion getSlotRegion(uint32_t page, uint32_t slot) const;
+	uint16_t getPageGlyph(uint32_t page, uint32_t slot) const { return static_cast<uint16_t>(baseGlyphCount + page * slotsPerPage + slot); }
+
+	std::string glyphDirectory;
+	uint32_t cellWidth;
+	uint32_t cellHeight;
+	uint8_t startChar;
+	uint32_t distanceFieldScale;
+	float distanceFieldSpread;
+
+	uint32_t width;
+	uint32_t height;
+	uint32_t bytesPerPixel;
+	uint32_t baseHeight;
+	uint32_t pageHeight;
+	uint32_t slotsPerPage;
+	uint32_t baseGlyphCount;
+	std::size_t maxPageCount;
+	std::vector<uint8_t> pixels;
+
+	std::vector<Page> pages;
+	std::list<uint32_t> lruPages;
+	std::unordered_map<char32_t, Glyph> glyphs;
+	std::unordered_set<char32_t> missingGlyphs;
+	std::vector<AtlasRegion> dirtyRegions;
+};
\ No newline at end of file
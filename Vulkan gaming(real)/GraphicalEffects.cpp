@@ -1,55 +1,34 @@
 #include "GraphicalEffects.h"
 
+#include "Components.h"
+
 ColorFlash::ColorFlash(Font const& font)
 	:font(font)
 {}
 
 ColorFlash::~ColorFlash()
 {
-	if (currentTimer < effectDuration)
-	{
-		ObjectPools::quads.remove(quad);
-	}
+	GameWorld::entities.destroy(quad);
 }
 
 void ColorFlash::start(glm::vec3 color, double duration)
 {
 	assert(duration > 0.0 && "ColorFlash with invalid timer");
 
-	if (currentTimer < effectDuration)
-	{
-		ObjectPools::quads.remove(quad);
-	}
+	GameWorld::entities.destroy(quad);
 
-	this->currentTimer = 0.0;
 	this->color = color;
-	this->effectDuration = duration;
-	ObjectPools::quads.add(QuadComponent({ -1.0f, -1.0f, -0.05f }, { 2.0f, 2.0f }, font.getCharOffset(29), font.getCharTextureScale(),
-		{ 0.0f, 0.0f, 0.0f, 0.0f }), &quad);
+	quad = GameWorld::entities.create(Transform{{ -1.0f, -1.0f, -0.05f }, { 2.0f, 2.0f }}, Tint{{ 0.0f, 0.0f, 0.0f, 0.0f }},
+		GlyphRegion{font.getCharGlyph(29)}, Lifetime{0.0, duration});
 }
 
+//the quad itself is destroyed by the lifetime system once the flash is over
 void ColorFlash::update()
 {
-	if (currentTimer < effectDuration)
+	if (GameWorld::entities.isAlive(quad))
 	{
-		currentTimer += TIME_STEP;
-		if (currentTimer >= effectDuration)
-		{
-			ObjectPools::quads.remove(quad);
-		}
-		else
-		{
-			glm::vec4 newColor;
-			if (currentTimer < effectDuration * 0.5)
-			{
-				newColor = glm::vec4(color, currentTimer / (effectDuration * 0.5));
-			}
-			else
-			{
-				newColor = glm::vec4(color, 1.0 - (currentTimer - effectDuration * 0.5) / (effectDuration * 0.5));
-			}
-			
-			(ObjectPools::quads.data() + quad)->setColor(newColor);
-		}
+		auto progress = GameWorld::entities.get<Lifetime>(quad).getProgress();
+		float alpha = static_cast<float>(progress < 0.5 ? progress * 2.0 : 2.0 - progress * 2.0);
+		GameWorld::entities.get<Tint>(quad).color = glm::vec4(color, alpha);
 	}
-}
+}
\ No newline at end of file
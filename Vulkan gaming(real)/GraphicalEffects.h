@@ -1,7 +1,7 @@
 #pragma once
 
 #include "constants.h"
-#include "ObjectPool.h"
+#include "EntityWorld.h"
 #include "Font.h"
 
 class ColorFlash
@@ -16,8 +16,6 @@ public:
 private:
 	Font font;
 	glm::vec3 color;
-	double effectDuration{};
-	double currentTimer{};
 
-	size_t quad{};
+	Entity quad;
 };
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "HitGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+//grid cell of a normalized coordinate, points outside [-1, 1] land in the border cells
+static uint32_t getCellCoordinate(float coordinate)
+{
+	auto cell = static_cast<int64_t>(std::floor((coordinate + 1.0f) * 0.5f * HIT_GRID_SIZE));
+	return static_cast<uint32_t>(std::clamp<int64_t>(cell, 0, HIT_GRID_SIZE - 1));
+}
+
+uint32_t HitGrid::add(glm::vec2 const& min, glm::vec2 const& max, float depth, PressHandler onPress, HoverHandler onHover)
+{
+	uint32_t region;
+	if (!freeRegions.empty())
+	{
+		region = freeRegions.back();
+		freeRegions.pop_back();
+	}
+	else
+	{
+		region = static_cast<uint32_t>(regions.size());
+		regions.emplace_back();
+	}
+
+	regions[region] = Region{min, max, depth, std::move(onPress), std::move(onHover), true};
+	insert(region);
+	return region;
+}
+
+void HitGrid::remove(uint32_t region)
+{
+	if (region >= regions.size() || !regions[region].alive) return;
+
+	erase(region);
+	regions[region] = Region{};
+	freeRegions.push_back(region);
+	if (hoveredRegion == region) hoveredRegion = NO_REGION;
+}
+
+void HitGrid::move(uint32_t region, glm::vec2 const& min, glm::vec2 const& max)
+{
+	erase(region);
+	regions[region].min = min;
+	regions[region].max = max;
+	insert(region);
+}
+
+void HitGrid::setDepth(uint32_t region, float depth)
+{
+	erase(region);
+	regions[region].depth = depth;
+	insert(region);
+}
+
+uint32_t HitGrid::find(glm::vec2 const& point) const
+{
+	for (auto region : cells[getCellIndex(point)])
+	{
+		auto const& bounds = regions[region];
+		if (point.x >= bounds.min.x && point.y >= bounds.min.y && point.x <= bounds.max.x && point.y <= bounds.max.y) return region;
+	}
+	return NO_REGION;
+}
+
+bool HitGrid::press(glm::vec2 const& point, int button)
+{
+	auto region = find(point);
+	if (region == NO_REGION) return false;
+
+	//the handler may add or remove regions, which can reallocate the one it lives in
+	auto onPress = regions[region].onPress;
+	if (onPress) onPress(point, button);
+	return true;
+}
+
+void HitGrid::hover(glm::vec2 const& point)
+{
+	auto region = find(point);
+	if (region == hoveredRegion) return;
+
+	auto previous = std::exchange(hoveredRegion, region);
+	if (previous != NO_REGION && regions[previous].onHover)
+	{
+		auto onHover = regions[previous].onHover;
+		onHover(false);
+	}
+	if (region != NO_REGION && regions[region].onHover)
+	{
+		auto onHover = regions[region].onHover;
+		onHover(true);
+	}
+}
+
+glm::uvec4 HitGrid::getCellRange(glm::vec2 const& min, glm::vec2 const& max) const
+{
+	return {getCellCoordinate(min.x), getCellCoordinate(min.y), getCellCoordinate(max.x) + 1, getCellCoordinate(max.y) + 1};
+}
+
+std::size_t HitGrid::getCellIndex(glm::vec2 const& point) const
+{
+	return std::size_t(getCellCoordinate(point.y)) * HIT_GRID_SIZE + getCellCoordinate(point.x);
+}
+
+void HitGrid::insert(uint32_t region)
+{
+	auto range = getCellRange(regions[region].min, regions[region].max);
+	auto depth = regions[region].depth;
+	for (auto y = range.y; y < range.w; y++)
+	{
+		for (auto x = range.x; x < range.z; x++)
+		{
+			auto& cell = cells[std::size_t(y) * HIT_GRID_SIZE + x];
+			auto position = std::upper_bound(cell.begin(), cell.end(), depth, [this](float depth, uint32_t other) { return depth < regions[other].depth; });
+			cell.insert(position, region);
+		}
+	}
+}
+
+void HitGrid::erase(uint32_t region)
+{
+	auto range = getCellRange(regions[region].min, regions[region].max);
+	for (auto y = range.y; y < range.w; y++)
+	{
+		for (auto x = range.x; x < range.z; x++)
+		{
+			auto& cell = cells[std::size_t(y) * HIT_GRID_SIZE + x];
+			cell.erase(std::find(cell.begin(), cell.end(), region));
+		}
+	}
+}
\ No newline at end of file
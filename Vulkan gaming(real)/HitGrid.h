@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "constants.h"
+
+//clickable rectangles in normalized screen space bucketed into a uniform grid of HIT_GRID_SIZE by HIT_GRID_SIZE cells
+//a lookup only tests the regions overlapping the cell under the point, each cell keeps its regions sorted front to back
+//smaller depth is in front, the same as the depth test
+class HitGrid
+{
+	struct Region
+	{
+		glm::vec2 min;
+		glm::vec2 max;
+		float depth;
+		std::function<void(glm::vec2 const&, int)> onPress;
+		std::function<void(bool)> onHover;
+		bool alive;
+	};
+
+public:
+	using PressHandler = std::function<void(glm::vec2 const& point, int button)>;
+	using HoverHandler = std::function<void(bool hovered)>;
+
+	static constexpr uint32_t NO_REGION = std::numeric_limits<uint32_t>::max();
+
+	uint32_t add(glm::vec2 const& min, glm::vec2 const& max, float depth, PressHandler onPress, HoverHandler onHover = {});
+	void remove(uint32_t region);
+	void move(uint32_t region, glm::vec2 const& min, glm::vec2 const& max);
+	void setDepth(uint32_t region, float depth);
+
+	//frontmost region containing point, NO_REGION if there is none
+	uint32_t find(glm::vec2 const& point) const;
+	//sends the press to the frontmost region under point, returns whether there was one
+	bool press(glm::vec2 const& point, int button);
+	//tells the regions the cursor entered and left since the last call
+	void hover(glm::vec2 const& point);
+
+	std::size_t getRegionCount() const { return regions.size() - freeRegions.size(); }
+
+private:
+	//first and one past last cell on each axis, as x begin, y begin, x end, y end
+	glm::uvec4 getCellRange(glm::vec2 const& min, glm::vec2 const& max) const;
+	std::size_t getCellIndex(glm::vec2 const& point) const;
+	void insert(uint32_t region);
+	void erase(uint32_t region);
+
+	std::array<std::vector<uint32_t>, HIT_GRID_SIZE * HIT_GRID_SIZE> cells;
+	std::vector<Region> regions;
+	std::vector<uint32_t> freeRegions;
+	uint32_t hoveredRegion = NO_REGION;
+};
\ No newline at end of file
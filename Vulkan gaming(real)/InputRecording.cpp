@@ -0,0 +1,115 @@
+#include "InputRecording.h"
+
+#include <bit>
+#include <cstring>
+
+#include "helpers.h"
+#include "logging.h"
+
+static bool hasPosition(EventType type)
+{
+	return type == EventType::eMouseButtonPress || type == EventType::eMouseButtonRelease || type == EventType::eFramebufferResize ||
+		type == EventType::eMouseScroll;
+}
+
+template<class T>
+static void writeValue(std::vector<uint8_t>& output, T value)
+{
+	auto bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>(value);
+	output.insert(output.end(), bytes.begin(), bytes.end());
+}
+
+template<class T>
+static bool readValue(std::span<uint8_t const> input, std::size_t& index, T& value)
+{
+	if (input.size() - index < sizeof(T)) return false;
+	std::memcpy(&value, input.data() + index, sizeof(T));
+	index += sizeof(T);
+	return true;
+}
+
+InputRecorder::InputRecorder(std::string const& filename, uint32_t seed)
+	:file(filename, std::ios::binary)
+{
+	errorFatal(bool(file), "couldn't open input recording: "s + filename);
+
+	writeValue(buffer, InputRecordingFormat::MAGIC);
+	writeValue(buffer, InputRecordingFormat::VERSION);
+	writeValue(buffer, seed);
+	flush();
+}
+
+InputRecorder::~InputRecorder()
+{
+	flush();
+}
+
+void InputRecorder::record(uint64_t tick, InputEvent const& event)
+{
+	writeVarint(buffer, tick - lastTick);
+	lastTick = tick;
+	buffer.push_back(static_cast<uint8_t>(event.type));
+	writeVarint(buffer, encodeZigzag(event.code));
+	if (hasPosition(event.type))
+	{
+		writeValue(buffer, static_cast<float>(event.x));
+		writeValue(buffer, static_cast<float>(event.y));
+	}
+
+	if (buffer.size() >= 4096) flush();
+}
+
+void InputRecorder::flush()
+{
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	file.flush();
+	buffer.clear();
+}
+
+InputReplay::InputReplay(std::string const& filename)
+{
+	auto fileData = readFile(filename);
+	data.assign(fileData.begin(), fileData.end());
+
+	uint32_t magic{}, version{};
+	bool validHeader = readValue(std::span<uint8_t const>(data), index, magic) && readValue(std::span<uint8_t const>(data), index, version) &&
+		readValue(std::span<uint8_t const>(data), index, seed);
+	errorFatal(validHeader && magic == InputRecordingFormat::MAGIC, "not an input recording: "s + filename);
+	errorFatal(version == InputRecordingFormat::VERSION, "unsupported input recording version: "s + filename);
+
+	//walk the file once to find where the session ends
+	auto startIndex = index;
+	while (readEntry()) lastTick = entryTick;
+	index = startIndex;
+	entryTick = 0;
+
+	hasEntry = readEntry();
+}
+
+void InputReplay::feedTick(uint64_t tick, EventHandler& eventHandler)
+{
+	while (hasEntry && entryTick <= tick)
+	{
+		eventHandler.queueEvent(entryEvent);
+		hasEntry = readEntry();
+	}
+}
+
+bool InputReplay::readEntry()
+{
+	std::span<uint8_t const> input(data);
+	uint64_t tickDelta{}, code{};
+	uint8_t type{};
+	if (!readVarint(input, index, tickDelta) || !readValue(input, index, type) || !readVarint(input, index, code)) return false;
+
+	entryTick += tickDelta;
+	entryEvent = InputEvent{0.0, static_cast<EventType>(type), static_cast<int>(decodeZigzag(code)), 0.0, 0.0};
+	if (hasPosition(entryEvent.type))
+	{
+		float x{}, y{};
+		if (!readValue(input, index, x) || !readValue(input, index, y)) return false;
+		entryEvent.x = x;
+		entryEvent.y = y;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "EventHandler.h"
+
+//binary session log: a header with the board seed followed by every consumed input event tagged with the update tick it was consumed on
+//ticks are stored as varint deltas and event codes as zigzag varints, cursor positions and sizes only for the event types that carry them
+namespace InputRecordingFormat
+{
+	static constexpr uint32_t MAGIC = 0x52495343;
+	static constexpr uint32_t VERSION = 2;
+}
+
+class InputRecorder
+{
+public:
+	InputRecorder(std::string const& filename, uint32_t seed);
+	~InputRecorder();
+
+	InputRecorder(InputRecorder const&) = delete;
+	InputRecorder& operator=(InputRecorder const&) = delete;
+
+	void record(uint64_t tick, InputEvent const& event);
+	void flush();
+
+private:
+	std::ofstream file;
+	std::vector<uint8_t> buffer;
+	uint64_t lastTick{};
+};
+
+class InputReplay
+{
+public:
+	explicit InputReplay(std::string const& filename);
+
+	uint32_t getSeed() const { return seed; }
+	uint64_t getLastTick() const { return lastTick; }
+	bool isFinished(uint64_t tick) const { return !hasEntry && tick > lastTick; }
+
+	//queues every recorded event of the given tick into the event handler as if it came from the window
+	void feedTick(uint64_t tick, EventHandler& eventHandler);
+
+private:
+	bool readEntry();
+
+	std::vector<uint8_t> data;
+	std::size_t index{};
+	uint32_t seed{};
+
+	bool hasEntry = false;
+	uint64_t entryTick{};
+	InputEvent entryEvent{};
+	uint64_t lastTick{};
+};
\ No newline at end of file
@@ -1,42 +1,118 @@
 #include "Map.h"
-#include "ObjectPool.h"
+#include "Components.h"
 
-#include <random>
+static glm::vec3 getCellColor(uint8_t glyph)
+{
+	switch (glyph)
+	{
+	case 'X':
+		return { 1.0f, 0.0f, 1.0f };
+	case '!':
+		return { 1.0f, 0.5f, 0.0f };
+	case '1':
+		return { 0.0f, 0.0f, 1.0f };
+	case '2':
+		return { 0.0f, 0.5f, 0.0f };
+	case '3':
+		return { 1.0f, 0.0f, 0.0f };
+	case '4':
+		return { 0.0f, 0.0f, 0.5f };
+	case '5':
+		return { 0.5f, 0.0f, 0.0f };
+	case '6':
+		return { 0.0f, 0.5f, 0.5f };
+	case '7':
+		return { 0.5f, 0.5f, 0.0f };
+	case '8':
+		return { 0.5f, 0.5f, 0.5f };
+	default:
+		return { 1.0f, 1.0f, 1.0f };
+	}
+}
 
-Map::Map(size_t width, size_t height, size_t mineCount, Font const& font, std::vector<RefWrapper<Observer>> const& observers)
-	:notifier{ NotifierType::eMap, observers }, width{ width }, height{ height },
-	position{ -1.0f, -14.0f / 16.0f, -0.1f }, scale{ 2.0f, 1.0f + 14.0f / 16.0f }, font{ font }, cells(width* height),
-	adjacencyOffsets{ {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1} },
-	coveredCellCount{ width * height }, currentState{ State::ePreparing }
+Map::Map(size_t width, size_t height, size_t mineCount, Font const& font, ConcurrentEventChannel<MapStateChanged>& stateChannel, uint32_t seed,
+	Mode mode, bool noGuess)
+	:stateChannel{ stateChannel }, mode{ mode }, noGuess{ noGuess && mode == Mode::eBounded }, width{ width }, height{ height },
+	position{ -1.0f, -14.0f / 16.0f, -0.1f }, scale{ 2.0f, 1.0f + 14.0f / 16.0f }, font{ font }, randomEngine{ seed },
+	tileMap{ static_cast<uint32_t>(width), static_cast<uint32_t>(height), position.z, font },
+	camera{ { position.x, position.y, scale.x, scale.y }, { static_cast<float>(width), static_cast<float>(height) } },
+	board{ width, height, mode, mode == Mode::eInfinite ? randomEngine() : 0 }
 {
-	populateMines(mineCount);
+	board.setObserver(this);
+	hitRegion = GameWorld::hitRegions.add(glm::vec2(position), glm::vec2(position) + scale, position.z,
+		[this](glm::vec2 const& point, int button) { onMousePressed(point.x, point.y, button == GLFW_MOUSE_BUTTON_LEFT); });
+	if (mode == Mode::eInfinite)
+	{
+		createCellQuads();
+		fitCamera();
+		return;
+	}
+
+	auto layout = this->noGuess ? generateNoGuessLayout(width, height, mineCount, randomEngine.split(), { width / 2, height / 2 }) :
+		generateBoardLayout(width, height, mineCount, randomEngine.split());
+	metrics = analyzeBoard(layout);
+	board.applyLayout(std::move(layout));
+	if (usesTileMap())
+	{
+		for (size_t glyph = 0; glyph < 256; glyph++)
+		{
+			tileMap.setPaletteColor(static_cast<uint8_t>(glyph), glm::vec4(getCellColor(static_cast<uint8_t>(glyph)), 1.0f));
+		}
+		tileMap.fill('#');
+		updateVisibleChunks();
+	}
+	else createCellQuads();
+	board.openStartCell();
+	requestNextLayout();
 }
 
 Map::~Map()
 {
+	//a pending no-guess generation would otherwise keep the future's destructor waiting for all of its trials
+	layoutStopSource.request_stop();
 	for (auto quad : cellQuads)
 	{
-		ObjectPools::quads.remove(quad);
+		GameWorld::entities.destroy(quad);
 	}
+	GameWorld::transformGroups.destroy(cellGroup);
+	GameWorld::hitRegions.remove(hitRegion);
 }
 
 void Map::onMousePressed(double xPos, double yPos, bool leftButton)
 {
 	if (inputBlocked) return;
 
-	int64_t xIndex = static_cast<int64_t>(std::floor((xPos - position.x) / scale.x * width));
-	int64_t yIndex = static_cast<int64_t>(std::floor((yPos - position.y) / scale.y * height));
-	if (!isIndexValid(xIndex, yIndex)) return;
+	int64_t xIndex{}, yIndex{};
+	if (usesTileMap())
+	{
+		glm::vec2 screenPoint{ xPos, yPos };
+		if (!camera.isInViewport(screenPoint)) return;
+		auto boardPoint = glm::floor(camera.screenToBoard(screenPoint));
+		xIndex = static_cast<int64_t>(boardPoint.x);
+		yIndex = static_cast<int64_t>(boardPoint.y);
+	}
+	else
+	{
+		xIndex = static_cast<int64_t>(std::floor((xPos - position.x) / scale.x * width));
+		yIndex = static_cast<int64_t>(std::floor((yPos - position.y) / scale.y * height));
+		if (mode == Mode::eInfinite)
+		{
+			if (xIndex < 0 || xIndex >= (int64_t)width || yIndex < 0 || yIndex >= (int64_t)height) return;
+			xIndex += viewOrigin.first;
+			yIndex += viewOrigin.second;
+		}
+	}
+	if (!board.isIndexValid(xIndex, yIndex)) return;
 
-	auto& clickedCell = getCellAtIndex(xIndex, yIndex);
+	auto& clickedCell = board.getCellAtIndex(xIndex, yIndex);
 	if (clickedCell.state == CellState::eCovered)
 	{
-		if (leftButton) pressCell(xIndex, yIndex);
-		else markCell(xIndex, yIndex);
+		if (leftButton) board.pressCell(xIndex, yIndex);
+		else board.markCell(xIndex, yIndex);
 	}
 	else if (clickedCell.state == CellState::eMarked)
 	{
-		if (!leftButton) unmarkCell(xIndex, yIndex);
+		if (!leftButton) board.unmarkCell(xIndex, yIndex);
 	}
 	else
 	{
@@ -47,7 +123,7 @@ void Map::onMousePressed(double xPos, double yPos, bool leftButton)
 
 void Map::onMouseReleased()
 {
-	if (inputBlocked && currentState == State::ePlaying)
+	if (inputBlocked && board.getCurrentState() == State::ePlaying)
 	{
 		uncheckCell(checkedCellIndices.first, checkedCellIndices.second);
 		inputBlocked = false;
@@ -56,194 +132,289 @@ void Map::onMouseReleased()
 
 void Map::reset()
 {
-	for (auto quad : cellQuads)
+	if (mode == Mode::eInfinite)
 	{
-		ObjectPools::quads.remove(quad);
+		board.resetInfinite(randomEngine());
+		fitCamera();
+		return;
 	}
-	cells = std::vector<Cell>(width * height);
-	coveredCellCount = width * height;
-	markedCellCount = 0;
 
-	populateMines((randInt() % (width * height / 4)) + 1);
+	auto layout = nextLayout.get();
+	metrics = analyzeBoard(layout);
+	pendingTileChunks.clear();
+	board.applyLayout(std::move(layout));
+	coverAllCells();
+	board.openStartCell();
+	requestNextLayout();
+}
+
+//not while a chord is held down, the highlighted neighbours would be left behind
+bool Map::undo()
+{
+	if (inputBlocked && board.getCurrentState() == State::ePlaying) return false;
+	return board.undo();
+}
 
-	changeState(State::ePreparing);
+bool Map::redo()
+{
+	if (inputBlocked && board.getCurrentState() == State::ePlaying) return false;
+	return board.redo();
 }
 
-void Map::populateMines(size_t newMineCount)
+bool Map::loadSnapshot(std::shared_ptr<GameSnapshot const> snapshot)
 {
-	cellQuads.resize(width * height);
+	if (mode == Mode::eInfinite || snapshot->getWidth() != width || snapshot->getHeight() != height) return false;
+
+	inputBlocked = false;
+	metrics = snapshot->getMetrics();
+	if (usesTileMap()) pendingTileChunks.assign(tileMap.getChunkCount(), true);
+	board.loadSnapshot(std::move(snapshot));
+	if (usesTileMap())
+	{
+		redrawPendingChunks();
+		return true;
+	}
+
 	for (size_t i = 0; i < height; i++)
 	{
 		for (size_t j = 0; j < width; j++)
 		{
-			glm::vec3 quadPosition{ scale.x / width * j + position.x, scale.y / height * i + position.y, position.z };
-			glm::vec2 quadScale{ scale.x / width, scale.y / height };
-			ObjectPools::quads.add(QuadComponent(quadPosition, quadScale, font.getCharOffset('#'), font.getCharTextureScale()), &cellQuads[i * width + j]);
+			changeCellQuad(j, i, Board::getCellGlyph(board.getCellAtIndex(j, i)));
 		}
 	}
+	return true;
+}
 
-	newMineCount = std::min(newMineCount, cells.size() - 1);
-	mineCount = newMineCount;
-	coveredCellCount -= newMineCount;
-	for (size_t i = 0; i < newMineCount; i++)
+void Map::panCamera(glm::vec2 const& screenDelta)
+{
+	if (mode == Mode::eInfinite)
 	{
-		cells[i].mined = true;
+		//the quad window scrolls by whole cells, the remainder carries over to the next pan
+		viewOffset += screenDelta / scale * glm::vec2(width, height);
+		auto cellDelta = glm::trunc(viewOffset);
+		viewOffset -= cellDelta;
+		if (cellDelta.x == 0.0f && cellDelta.y == 0.0f) return;
+
+		viewOrigin.first += static_cast<int64_t>(cellDelta.x);
+		viewOrigin.second += static_cast<int64_t>(cellDelta.y);
+		refreshView();
+		return;
 	}
-	std::random_device rd;
-	std::minstd_rand gen(rd());
-	std::shuffle(cells.begin(), cells.end(), gen);
+
+	camera.pan(screenDelta);
+	updateVisibleChunks();
 }
 
-void Map::pressCell(size_t xIndex, size_t yIndex)
+void Map::zoomCamera(float factor, glm::vec2 const& screenPoint)
 {
-	uint8_t adjacentMinesCount = countAdjacentMines(xIndex, yIndex);
+	if (mode == Mode::eInfinite) return;
 
-	auto& pressedCell = getCellAtIndex(xIndex, yIndex);
-	pressedCell.state = CellState::eUncovered;
+	camera.zoomAt(factor, screenPoint);
+	updateVisibleChunks();
+}
 
-	if (pressedCell.mined)
-	{
-		adjacentMinesCount = 'X';
-		changeState(State::eLost);
-	}
-	else if (adjacentMinesCount == '0')
+void Map::fitCamera()
+{
+	if (mode == Mode::eInfinite)
 	{
-		adjacentMinesCount = ' ';
-		pressAdjacentCells(xIndex, yIndex);
+		viewOrigin = { -static_cast<int64_t>(width / 2), -static_cast<int64_t>(height / 2) };
+		viewOffset = {};
+		refreshView();
+		return;
 	}
 
-	if (adjacentMinesCount != 'X')
-	{
-		coveredCellCount--;
-		if (coveredCellCount == 0) changeState(State::eWon);
-		else if (currentState == State::ePreparing) changeState(State::ePlaying);
-	}
+	camera.fit();
+	updateVisibleChunks();
+}
+
+SolverInput Map::getSolverInput()
+{
+	return board.getSolverInput(mode == Mode::eInfinite ? viewOrigin : std::pair<int64_t, int64_t>{});
+}
 
-	changeCellQuad(xIndex, yIndex, adjacentMinesCount);
+void Map::pressSolverCell(std::size_t index)
+{
+	if (inputBlocked) return;
+
+	auto [xIndex, yIndex] = getSolverCellCoordinates(index);
+	if (board.getCellAtIndex(xIndex, yIndex).state == CellState::eCovered) board.pressCell(xIndex, yIndex);
 }
 
-void Map::markCell(size_t xIndex, size_t yIndex)
+void Map::markSolverCell(std::size_t index)
 {
-	getCellAtIndex(xIndex, yIndex).state = CellState::eMarked;
-	markedCellCount++;
-	changeCellQuad(xIndex, yIndex, '!');
+	if (inputBlocked) return;
+
+	auto [xIndex, yIndex] = getSolverCellCoordinates(index);
+	if (board.getCellAtIndex(xIndex, yIndex).state == CellState::eCovered) board.markCell(xIndex, yIndex);
 }
 
-void Map::unmarkCell(size_t xIndex, size_t yIndex)
+std::pair<int64_t, int64_t> Map::getSolverCellCoordinates(std::size_t index) const
 {
-	getCellAtIndex(xIndex, yIndex).state = CellState::eCovered;
-	markedCellCount--;
-	changeCellQuad(xIndex, yIndex, '#');
+	int64_t xIndex = static_cast<int64_t>(index % width);
+	int64_t yIndex = static_cast<int64_t>(index / width);
+	if (mode == Mode::eInfinite) return { xIndex + viewOrigin.first, yIndex + viewOrigin.second };
+	return { xIndex, yIndex };
 }
 
-void Map::checkCell(size_t xIndex, size_t yIndex)
+void Map::createCellQuads()
 {
-	for (auto&& [xOffset, yOffset] : adjacencyOffsets)
+	cellGroup = GameWorld::transformGroups.create(position);
+	cellQuads.reserve(width * height);
+	for (size_t i = 0; i < height; i++)
 	{
-		int64_t xAdjacent = xIndex + xOffset;
-		int64_t yAdjacent = yIndex + yOffset;
-		if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
+		for (size_t j = 0; j < width; j++)
 		{
-			changeCellQuad(xAdjacent, yAdjacent, '?');
+			glm::vec3 quadPosition{ scale.x / width * j, scale.y / height * i, 0.0f };
+			glm::vec2 quadScale{ scale.x / width, scale.y / height };
+			cellQuads.push_back(GameWorld::entities.create(Transform{quadPosition, quadScale, cellGroup}, Tint{},
+				GlyphRegion{font.getCharGlyph('#')}));
 		}
 	}
-	checkedCellIndices = { xIndex, yIndex };
 }
 
-void Map::uncheckCell(size_t xIndex, size_t yIndex)
+void Map::coverAllCells()
 {
-	if (countAdjacentMarks(xIndex, yIndex) == countAdjacentMines(xIndex, yIndex))
+	if (usesTileMap())
 	{
-		pressAdjacentCells(xIndex, yIndex);
+		tileMap.fill('#');
+		return;
 	}
-	else
+	for (size_t i = 0; i < height; i++)
 	{
-		for (auto&& [xOffset, yOffset] : adjacencyOffsets)
+		for (size_t j = 0; j < width; j++)
 		{
-			int64_t xAdjacent = xIndex + xOffset;
-			int64_t yAdjacent = yIndex + yOffset;
-			if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
-			{
-				changeCellQuad(xAdjacent, yAdjacent, '#');
-			}
+			changeCellQuad(j, i, '#');
 		}
 	}
 }
 
-void Map::pressAdjacentCells(size_t xIndex, size_t yIndex)
+void Map::requestNextLayout()
 {
-	for (auto&& [xOffset, yOffset] : adjacencyOffsets)
+	size_t nextMineCount = randomEngine.nextBelow(width * height / 4) + 1;
+	auto layoutRandom = randomEngine.split();
+	if (noGuess)
 	{
-		int64_t xAdjacent = xIndex + xOffset;
-		int64_t yAdjacent = yIndex + yOffset;
-		if (isIndexValid(xAdjacent, yAdjacent) && getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
-		{
-			pressCell(xAdjacent, yAdjacent);
-		}
+		nextLayout = std::async(std::launch::async, generateNoGuessLayout, width, height, nextMineCount, layoutRandom, std::pair{ width / 2, height / 2 },
+			layoutStopSource.get_token(), std::thread::hardware_concurrency());
 	}
+	else nextLayout = std::async(std::launch::async, generateBoardLayout, width, height, nextMineCount, layoutRandom, std::nullopt);
 }
 
-Map::Cell& Map::getCellAtIndex(size_t xIndex, size_t yIndex)
+void Map::updateVisibleChunks()
 {
-	return cells[xIndex + width * yIndex];
+	tileMap.setVisibleRect(camera.getVisibleRect());
+	redrawPendingChunks();
 }
 
-void Map::changeCellQuad(size_t xIndex, size_t yIndex, uint8_t newQuad)
+//decodes the board chunks behind the visible tiles in parallel, the rest of a loaded snapshot is left untouched until it scrolls into view
+void Map::redrawPendingChunks()
 {
-	ObjectPools::quads.remove(cellQuads[xIndex + yIndex * width]);
+	if (pendingTileChunks.empty()) return;
 
-	glm::vec3 cellColor{ 1.0f, 1.0f, 1.0f };
-	switch (newQuad)
+	std::vector<size_t> chunks;
+	auto visibleChunks = tileMap.getVisibleChunks();
+	for (size_t chunkY = visibleChunks.y; chunkY < visibleChunks.w; chunkY++)
 	{
-	case 'X':
-		cellColor = { 1.0f, 0.0f, 1.0f };
-		break;
-	case '!':
-		cellColor = { 1.0f, 0.5f, 0.0f };
-		break;
-	case '1':
-		cellColor = { 0.0f, 0.0f, 1.0f };
-		break;
-	case '2':
-		cellColor = { 0.0f, 0.5f, 0.0f };
-		break;
-	case '3':
-		cellColor = { 1.0f, 0.0f, 0.0f };
-		break;
-	case '4':
-		cellColor = { 0.0f, 0.0f, 0.5f };
-		break;
-	case '5':
-		cellColor = { 0.5f, 0.0f, 0.0f };
-		break;
-	case '6':
-		cellColor = { 0.0f, 0.5f, 0.5f };
-		break;
-	case '7':
-		cellColor = { 0.5f, 0.5f, 0.0f };
-		break;
-	case '8':
-		cellColor = { 0.5f, 0.5f, 0.5f };
-		break;
-	default:
-		break;
+		for (size_t chunkX = visibleChunks.x; chunkX < visibleChunks.z; chunkX++)
+		{
+			auto chunk = chunkY * tileMap.getChunkCountX() + chunkX;
+			if (pendingTileChunks[chunk]) chunks.push_back(chunk);
+		}
+	}
+	if (chunks.empty()) return;
+
+	board.decodeChunks(chunks, systemThreads);
+	for (auto chunk : chunks)
+	{
+		pendingTileChunks[chunk] = false;
+		auto chunkX = chunk % tileMap.getChunkCountX();
+		auto chunkY = chunk / tileMap.getChunkCountX();
+		for (size_t i = chunkY * BOARD_CHUNK_SIZE; i < std::min<size_t>((chunkY + 1) * BOARD_CHUNK_SIZE, height); i++)
+		{
+			for (size_t j = chunkX * BOARD_CHUNK_SIZE; j < std::min<size_t>((chunkX + 1) * BOARD_CHUNK_SIZE, width); j++)
+			{
+				tileMap.setTile(j, i, Board::getCellGlyph(board.getCellAtIndex(j, i)));
+			}
+		}
 	}
+}
 
-	glm::vec3 quadPosition{ scale.x / width * xIndex + position.x, scale.y / height * yIndex + position.y, position.z };
-	glm::vec2 quadScale{ scale.x / width, scale.y / height };
-	ObjectPools::quads.add(QuadComponent(quadPosition, quadScale, font.getCharOffset(newQuad), font.getCharTextureScale(), glm::vec4(cellColor, 1.0f)), &cellQuads[yIndex * width + xIndex]);
+//redraws the quad window of an infinite board, cells that were never touched show as covered without creating their chunk
+void Map::refreshView()
+{
+	for (size_t i = 0; i < height; i++)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			int64_t xIndex = viewOrigin.first + static_cast<int64_t>(j);
+			int64_t yIndex = viewOrigin.second + static_cast<int64_t>(i);
+			auto cell = board.findCell(xIndex, yIndex);
+			changeCellQuad(xIndex, yIndex, cell ? Board::getCellGlyph(*cell) : '#');
+		}
+	}
 }
 
-bool Map::isIndexValid(int64_t xIndex, int64_t yIndex)
+void Map::onCellChanged(int64_t xIndex, int64_t yIndex, uint8_t glyph)
 {
-	return xIndex >= 0 && xIndex < (int64_t)width&& yIndex >= 0 && yIndex < (int64_t)height;
+	changeCellQuad(xIndex, yIndex, glyph);
 }
 
-void Map::changeState(State newState)
+void Map::onStateChanged(State newState)
 {
 	inputBlocked = newState == State::eLost || newState == State::eWon;
-	currentState = newState;
-	notifier.notify((size_t)newState);
+	stateChannel.publish(MapStateChanged{ newState });
 }
 
+void Map::onActionApplied(ActionJournal::Action const& action, ActionJournal::Change change)
+{
+	if (actionListener) actionListener(action, change);
+}
+
+void Map::checkCell(int64_t xIndex, int64_t yIndex)
+{
+	for (auto&& [xOffset, yOffset] : Board::ADJACENCY_OFFSETS)
+	{
+		int64_t xAdjacent = xIndex + xOffset;
+		int64_t yAdjacent = yIndex + yOffset;
+		if (board.isIndexValid(xAdjacent, yAdjacent) && board.getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
+		{
+			changeCellQuad(xAdjacent, yAdjacent, '?');
+		}
+	}
+	checkedCellIndices = { xIndex, yIndex };
+}
+
+void Map::uncheckCell(int64_t xIndex, int64_t yIndex)
+{
+	if (board.chordCell(xIndex, yIndex)) return;
+
+	for (auto&& [xOffset, yOffset] : Board::ADJACENCY_OFFSETS)
+	{
+		int64_t xAdjacent = xIndex + xOffset;
+		int64_t yAdjacent = yIndex + yOffset;
+		if (board.isIndexValid(xAdjacent, yAdjacent) && board.getCellAtIndex(xAdjacent, yAdjacent).state == CellState::eCovered)
+		{
+			changeCellQuad(xAdjacent, yAdjacent, '#');
+		}
+	}
+}
+
+void Map::changeCellQuad(int64_t xIndex, int64_t yIndex, uint8_t newQuad)
+{
+	if (usesTileMap())
+	{
+		tileMap.setTile(xIndex, yIndex, newQuad);
+		return;
+	}
+	if (mode == Mode::eInfinite)
+	{
+		//only cells inside the window have a quad, the store keeps the rest
+		xIndex -= viewOrigin.first;
+		yIndex -= viewOrigin.second;
+		if (xIndex < 0 || xIndex >= (int64_t)width || yIndex < 0 || yIndex >= (int64_t)height) return;
+	}
 
+	auto quad = cellQuads[yIndex * width + xIndex];
+	GameWorld::entities.get<GlyphRegion>(quad).glyph = font.getCharGlyph(newQuad);
+	GameWorld::entities.get<Tint>(quad).color = glm::vec4(getCellColor(newQuad), 1.0f);
+}
\ No newline at end of file
@@ -1,106 +1,124 @@
 #pragma once
 
 #include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stop_token>
 
 #include "constants.h"
 #include "Text.h"
-#include "Observer.h"
+#include "TileMap.h"
+#include "Camera.h"
+#include "Board.h"
+#include "BoardAnalysis.h"
+#include "EventBus.h"
+#include "GameSnapshot.h"
 
 class Game;
+struct MapStateChanged;
 
-class Map
+class Map : private Board::Observer
 {
-	enum class CellState
-	{
-		eCovered, eUncovered, eMarked
-	};
-	struct Cell
-	{
-		bool mined = false;
-		CellState state = CellState::eCovered;
-	};
+	using CellState = BoardLayout::CellState;
+	using Cell = BoardLayout::Cell;
 
 public:
-	enum class State : size_t
-	{
-		ePlaying, eLost, eWon, ePreparing
-	};
+	using State = Board::State;
+	using Mode = Board::Mode;
 
 public:
-	Map(size_t width, size_t height, size_t mineCount, Font const& font, std::vector<RefWrapper<Observer>> const& observers);
+	//no-guess boards come with their opening uncovered and can be cleared from there without guessing, they only apply to bounded boards
+	Map(size_t width, size_t height, size_t mineCount, Font const& font, ConcurrentEventChannel<MapStateChanged>& stateChannel, uint32_t seed,
+		Mode mode = Mode::eBounded, bool noGuess = false);
 	~Map();
 
 	void onMousePressed(double xPos, double yPos, bool leftButton);
 	void onMouseReleased();
 
 	void reset();
-
-	Notifier notifier;
-
-	State getCurrentState() const { return currentState; }
-	size_t getMineCount() const { return mineCount; }
-	size_t getMarkedCellCount() const { return markedCellCount; }
-	size_t getCoveredCellCount() const { return coveredCellCount; }
+	bool undo();
+	bool redo();
+	//only snapshots of a bounded board with this map's size, tiles are redrawn from the snapshot as their chunks come into view
+	bool loadSnapshot(std::shared_ptr<GameSnapshot const> snapshot);
+	void setActionListener(std::function<void(ActionJournal::Action const&, ActionJournal::Change)> listener) { actionListener = std::move(listener); }
+	void setSystemThreads(ThreadPool* newSystemThreads) { systemThreads = newSystemThreads; }
+
+	void panCamera(glm::vec2 const& screenDelta);
+	void zoomCamera(float factor, glm::vec2 const& screenPoint);
+	void fitCamera();
+
+	//the solver sees the whole board, or the window of an infinite one, and refers to cells by their index in that view
+	SolverInput getSolverInput();
+	void pressSolverCell(std::size_t index);
+	void markSolverCell(std::size_t index);
+	std::pair<int64_t, int64_t> getSolverCellCoordinates(std::size_t index) const;
+
+	State getCurrentState() const { return board.getCurrentState(); }
+	size_t getMineCount() const { return board.getMineCount(); }
+	size_t getMarkedCellCount() const { return board.getMarkedCellCount(); }
+	size_t getCoveredCellCount() const { return board.getCoveredCellCount(); }
 	size_t getCellCount() const { return width * height; }
+	bool isInfinite() const { return mode == Mode::eInfinite; }
+	Board const& getBoard() const { return board; }
+	Board& getBoard() { return board; }
+	//metrics of the current bounded board, all zero on infinite ones
+	BoardMetrics const& getBoardMetrics() const { return metrics; }
+	TileMap* getTileMap() { return usesTileMap() ? &tileMap : nullptr; }
+	Camera const* getCamera() const { return usesTileMap() ? &camera : nullptr; }
 
 private:
-	void populateMines(size_t newMineCount);
-
-	void pressCell(size_t xIndex, size_t yIndex);
-	void markCell(size_t xIndex, size_t yIndex);
-	void unmarkCell(size_t xIndex, size_t yIndex);
-	void checkCell(size_t xIndex, size_t yIndex);
-	void uncheckCell(size_t xIndex, size_t yIndex);
-
-	void pressAdjacentCells(size_t xIndex, size_t yIndex);
-
-	template<class Condition>
-	uint8_t countAdjacentStates(size_t xIndex, size_t yIndex, Condition condition)
-	{
-		uint8_t stateCount = '0';
-		for (auto&& [xOffset, yOffset] : adjacencyOffsets)
-		{
-			int64_t xAdjacent = xIndex + xOffset;
-			int64_t yAdjacent = yIndex + yOffset;
-			if (isIndexValid(xAdjacent, yAdjacent) && condition(xAdjacent, yAdjacent))
-			{
-				stateCount++;
-			}
-		}
-		return stateCount;
-	}
-	uint8_t countAdjacentMines(size_t xIndex, size_t yIndex) 
-	{
-		return countAdjacentStates(xIndex, yIndex, [&](size_t xIndex, size_t yIndex) { return getCellAtIndex(xIndex, yIndex).mined; });
-	}
-	uint8_t countAdjacentMarks(size_t xIndex, size_t yIndex)
-	{
-		return countAdjacentStates(xIndex, yIndex, [&](size_t xIndex, size_t yIndex) { return getCellAtIndex(xIndex, yIndex).state == CellState::eMarked; });
-	}
-
-	Cell& getCellAtIndex(size_t xIndex, size_t yIndex);
-	void changeCellQuad(size_t xIndex, size_t yIndex, uint8_t newQuad);
-
-	bool isIndexValid(int64_t xIndex, int64_t yIndex);
-
-	void changeState(State newState);
+	void onCellChanged(int64_t xIndex, int64_t yIndex, uint8_t glyph) override;
+	void onStateChanged(State newState) override;
+	void onActionApplied(ActionJournal::Action const& action, ActionJournal::Change change) override;
+
+	void createCellQuads();
+	void coverAllCells();
+	void requestNextLayout();
+	void updateVisibleChunks();
+	void redrawPendingChunks();
+	void refreshView();
+	bool usesTileMap() const { return USE_TILE_MAP_RENDERER && mode == Mode::eBounded; }
+
+	void checkCell(int64_t xIndex, int64_t yIndex);
+	void uncheckCell(int64_t xIndex, int64_t yIndex);
+
+	void changeCellQuad(int64_t xIndex, int64_t yIndex, uint8_t newQuad);
+
+	ConcurrentEventChannel<MapStateChanged>& stateChannel;
+	Mode mode;
+	bool noGuess;
 
 	bool inputBlocked = false;
-	std::pair<size_t, size_t> checkedCellIndices;
+	std::pair<int64_t, int64_t> checkedCellIndices;
 
 	size_t width;
 	size_t height;
-	size_t mineCount{};
 	glm::vec3 position;
 	glm::vec2 scale;
 	Font font;
-
-	std::vector<std::pair<int64_t, int64_t>> adjacencyOffsets;
-
-	std::vector<size_t> cellQuads;
-	std::vector<Cell> cells;
-
-	size_t coveredCellCount;
-	size_t markedCellCount{};
-	State currentState;
+	//every board takes its own split of this, so generating one on another thread never touches the map's stream
+	Random randomEngine;
+
+	std::vector<Entity> cellQuads;
+	//transform group the cell quads are placed in
+	uint32_t cellGroup = TransformGroups::ROOT;
+	uint32_t hitRegion;
+	TileMap tileMap;
+	//tile chunks still showing the previous board after a snapshot was loaded
+	std::vector<bool> pendingTileChunks;
+	Camera camera;
+	std::pair<int64_t, int64_t> viewOrigin{};
+	glm::vec2 viewOffset{};
+	Board board;
+	BoardMetrics metrics;
+	std::future<BoardLayout> nextLayout;
+	std::stop_source layoutStopSource;
+	std::function<void(ActionJournal::Action const&, ActionJournal::Change)> actionListener;
+	ThreadPool* systemThreads{};
+};
+
+struct MapStateChanged
+{
+	Map::State newState;
 };
\ No newline at end of file
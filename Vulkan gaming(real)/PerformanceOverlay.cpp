@@ -0,0 +1,166 @@
+#include "PerformanceOverlay.h"
+
+#include <chrono>
+#include <format>
+
+#include "Components.h"
+
+struct MetricInfo
+{
+	std::string_view name;
+	std::string_view unit;
+};
+
+static constexpr std::array<MetricInfo, 7> METRIC_INFO{
+	MetricInfo{"frame"sv, "ms"sv},
+	MetricInfo{"ticks"sv, ""sv},
+	MetricInfo{"entities"sv, ""sv},
+	MetricInfo{"upload"sv, "KB"sv},
+	MetricInfo{"gpu"sv, "ms"sv},
+	MetricInfo{"click"sv, "ms"sv},
+	MetricInfo{"hud"sv, "us"sv}
+};
+
+PerformanceOverlay::PerformanceOverlay(glm::vec3 const& position, glm::vec2 const& size, Font const& font)
+	:position(position), size(size), font(font)
+{}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+	if (enabled) hide();
+}
+
+void PerformanceOverlay::toggle()
+{
+	if (enabled) hide();
+	else show();
+}
+
+void PerformanceOverlay::record(PerformanceSample const& sample)
+{
+	if (!enabled) return;
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	gpuTimeAvailable = sample.gpuTimeAvailable;
+	std::array<double, std::to_underlying(Metric::eCount)> values{sample.frameTime * 1000.0, static_cast<double>(sample.updateTicks),
+		static_cast<double>(sample.entityCount), sample.uploadedBytes / 1024.0, sample.gpuTimeAvailable ? sample.gpuTime * 1000.0 : 0.0, sample.clickLatency * 1000.0, overlayTime * 1000000.0};
+
+	std::size_t nextColumn = (currentColumn + 1) % PERFORMANCE_OVERLAY_SAMPLES;
+	for (std::size_t i = 0; i < graphs.size(); i++)
+	{
+		auto& graph = graphs[i];
+		graph.sampleSum += values[i] - graph.samples[currentColumn];
+		graph.samples[currentColumn] = values[i];
+		setBar(Metric(i), currentColumn, values[i]);
+		setBar(Metric(i), nextColumn, 0.0);
+	}
+	currentColumn = nextColumn;
+
+	labelTimer += sample.frameTime;
+	if (labelTimer >= PERFORMANCE_OVERLAY_LABEL_INTERVAL)
+	{
+		labelTimer = 0.0;
+		updateLabels();
+	}
+
+	overlayTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void PerformanceOverlay::show()
+{
+	enabled = true;
+	for (std::size_t i = 0; i < graphs.size(); i++)
+	{
+		auto& graph = graphs[i];
+		graph.samples.fill(0.0);
+		graph.sampleSum = 0.0;
+		for (auto& barQuad : graph.barQuads)
+		{
+			barQuad = GameWorld::entities.create(Transform{glm::vec3(position.x, getRowY(Metric(i)), position.z), glm::vec2(0.0f, 0.0f)}, Tint{},
+				GlyphRegion{font.getCharGlyph(29)});
+		}
+	}
+	currentColumn = 0;
+	labelTimer = 0.0;
+	updateLabels();
+}
+
+void PerformanceOverlay::hide()
+{
+	enabled = false;
+	for (auto& graph : graphs)
+	{
+		for (auto barQuad : graph.barQuads)
+		{
+			GameWorld::entities.destroy(barQuad);
+		}
+		graph.label.reset();
+	}
+}
+
+void PerformanceOverlay::setBar(Metric metric, std::size_t column, double value)
+{
+	float barWidth = size.x / PERFORMANCE_OVERLAY_SAMPLES;
+	float graphHeight = size.y / graphs.size() - font.scale * 1.25f;
+	float fraction = std::clamp(static_cast<float>(value / getFullScale(metric)), 0.0f, 1.0f);
+	float barHeight = graphHeight * fraction;
+
+	auto quad = graphs[std::to_underlying(metric)].barQuads[column];
+	GameWorld::entities.get<Transform>(quad) = Transform{glm::vec3(position.x + column * barWidth, getRowY(metric) + font.scale + graphHeight - barHeight, position.z),
+		glm::vec2(barWidth * 0.8f, barHeight)};
+	GameWorld::entities.get<Tint>(quad).color = glm::vec4(fraction, 1.0f - fraction, 0.0f, 0.8f);
+}
+
+void PerformanceOverlay::updateLabels()
+{
+	for (std::size_t i = 0; i < graphs.size(); i++)
+	{
+		auto& graph = graphs[i];
+		double average = graph.sampleSum / PERFORMANCE_OVERLAY_SAMPLES;
+
+		std::string text;
+		if (Metric(i) == Metric::eGpuTime && !gpuTimeAvailable)
+		{
+			text = std::format("{} n/a"sv, METRIC_INFO[i].name);
+		}
+		else if (Metric(i) == Metric::eFrameTime && average > 0.0)
+		{
+			text = std::format("{} {:.2f} {} {:.0f} fps"sv, METRIC_INFO[i].name, average, METRIC_INFO[i].unit, 1000.0 / average);
+		}
+		else
+		{
+			text = std::format("{} {:.2f} {}"sv, METRIC_INFO[i].name, average, METRIC_INFO[i].unit);
+		}
+
+		if (graph.label) graph.label->setText(text);
+		else graph.label = std::make_unique<Text>(text, font, glm::vec3(position.x, getRowY(Metric(i)), position.z));
+	}
+}
+
+double PerformanceOverlay::getFullScale(Metric metric) const
+{
+	switch (metric)
+	{
+	case Metric::eFrameTime:
+	case Metric::eGpuTime:
+		return 1000.0 / 30.0;
+	case Metric::eClickLatency:
+		return 1000.0 / 15.0;
+	case Metric::eUpdateTicks:
+		return 4.0;
+	case Metric::eEntityCount:
+		return static_cast<double>(MAX_QUAD_INSTANCES);
+	case Metric::eUploadedBytes:
+		return static_cast<double>(MAX_QUAD_INSTANCES * sizeof(PackedInstance)) / 1024.0;
+	case Metric::eOverlayTime:
+		return 1000.0;
+	default:
+		return 1.0;
+	}
+}
+
+float PerformanceOverlay::getRowY(Metric metric) const
+{
+	return position.y + std::to_underlying(metric) * size.y / graphs.size();
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "constants.h"
+#include "Font.h"
+#include "Text.h"
+
+struct PerformanceSample
+{
+	double frameTime;
+	uint64_t updateTicks;
+	uint64_t entityCount;
+	uint64_t uploadedBytes;
+	double gpuTime;
+	bool gpuTimeAvailable;
+	double clickLatency;
+};
+
+//live graphs of frame statistics drawn with bar quad entities
+//every recorded sample rewrites two bars per graph, labels are refreshed at a fixed interval, the overlay times itself as one of the graphs
+class PerformanceOverlay
+{
+	enum class Metric : std::size_t
+	{
+		eFrameTime, eUpdateTicks, eEntityCount, eUploadedBytes, eGpuTime, eClickLatency, eOverlayTime, eCount
+	};
+	struct Graph
+	{
+		std::array<double, PERFORMANCE_OVERLAY_SAMPLES> samples{};
+		double sampleSum{};
+		std::array<Entity, PERFORMANCE_OVERLAY_SAMPLES> barQuads{};
+		std::unique_ptr<Text> label;
+	};
+
+public:
+	PerformanceOverlay(glm::vec3 const& position, glm::vec2 const& size, Font const& font);
+	~PerformanceOverlay();
+
+	void toggle();
+	bool isEnabled() const { return enabled; }
+
+	void record(PerformanceSample const& sample);
+
+private:
+	void show();
+	void hide();
+	void setBar(Metric metric, std::size_t column, double value);
+	void updateLabels();
+	double getFullScale(Metric metric) const;
+	float getRowY(Metric metric) const;
+
+	bool enabled = false;
+	bool gpuTimeAvailable = false;
+	glm::vec3 position;
+	glm::vec2 size;
+	Font font;
+
+	std::array<Graph, std::to_underlying(Metric::eCount)> graphs;
+	std::size_t currentColumn{};
+	double labelTimer{};
+	double overlayTime{};
+};
\ No newline at end of file
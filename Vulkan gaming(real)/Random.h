@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//splitmix64 finalizer, a stateless mix usable as a hash of coordinates
+inline uint64_t mixBits(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+//xoshiro256**, every object is its own stream so threads never share generator state
+//the state is filled by splitmix64 from the seed, numbered streams of one seed are seeded apart and jump or split give streams that provably never overlap
+class Random
+{
+public:
+	using result_type = uint64_t;
+
+	explicit Random(uint64_t seed = 0, uint64_t stream = 0)
+	{
+		uint64_t counter = seed ^ mixBits(stream);
+		for (auto& word : state)
+		{
+			counter += 0x9E3779B97F4A7C15ULL;
+			word = mixBits(counter);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	uint64_t operator()()
+	{
+		uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+		uint64_t shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = rotateLeft(state[3], 45);
+		return result;
+	}
+
+	//uniform in [0, bound) by multiply and shift with rejection, unlike uniform_int_distribution the results are the same with every standard library
+	uint64_t nextBelow(uint64_t bound)
+	{
+		uint64_t low{};
+		uint64_t high = multiplyHigh((*this)(), bound, low);
+		if (low < bound)
+		{
+			uint64_t threshold = (0 - bound) % bound;
+			while (low < threshold) high = multiplyHigh((*this)(), bound, low);
+		}
+		return high;
+	}
+
+	//same as 2^128 calls
+	void jump()
+	{
+		static constexpr std::array<uint64_t, 4> JUMP{ 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+		std::array<uint64_t, 4> jumped{};
+		for (auto word : JUMP)
+		{
+			for (int bit = 0; bit < 64; bit++)
+			{
+				if ((word >> bit) & 1)
+				{
+					for (std::size_t i = 0; i < state.size(); i++) jumped[i] ^= state[i];
+				}
+				(*this)();
+			}
+		}
+		state = jumped;
+	}
+
+	//hands out the stream at the current position and moves this one past it, so a generator can feed any number of workers
+	Random split()
+	{
+		auto stream = *this;
+		jump();
+		return stream;
+	}
+
+private:
+	static uint64_t rotateLeft(uint64_t value, int shift) { return (value << shift) | (value >> (64 - shift)); }
+	static uint64_t multiplyHigh(uint64_t left, uint64_t right, uint64_t& low)
+	{
+#ifdef _MSC_VER
+		uint64_t high{};
+		low = _umul128(left, right, &high);
+		return high;
+#else
+		auto product = static_cast<unsigned __int128>(left) * right;
+		low = static_cast<uint64_t>(product);
+		return static_cast<uint64_t>(product >> 64);
+#endif
+	}
+
+	std::array<uint64_t, 4> state;
+};
\ No newline at end of file
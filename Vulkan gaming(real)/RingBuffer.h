@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+//single producer single consumer queue with a fixed power of two capacity
+//the consumer reads a snapshot of queued elements in place and then consumes them, push fails when the queue is full
+template<class T, std::size_t Capacity>
+class RingBuffer
+{
+	static_assert(std::has_single_bit(Capacity), "ring buffer capacity must be a power of two");
+
+public:
+	class Iterator
+	{
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = T;
+
+		Iterator() = default;
+		Iterator(T const* elements, std::size_t position)
+			:elements(elements), position(position)
+		{}
+
+		T const& operator*() const { return elements[position & (Capacity - 1)]; }
+		T const* operator->() const { return &**this; }
+		Iterator& operator++() { position++; return *this; }
+		Iterator operator++(int) { auto result = *this; position++; return result; }
+		bool operator==(Iterator const& other) const { return position == other.position; }
+
+	private:
+		T const* elements{};
+		std::size_t position{};
+	};
+
+	class View
+	{
+	public:
+		View(T const* elements, std::size_t first, std::size_t last)
+			:elements(elements), first(first), last(last)
+		{}
+
+		Iterator begin() const { return Iterator(elements, first); }
+		Iterator end() const { return Iterator(elements, last); }
+		std::size_t size() const { return last - first; }
+		bool empty() const { return first == last; }
+
+	private:
+		T const* elements;
+		std::size_t first;
+		std::size_t last;
+	};
+
+	RingBuffer() = default;
+	RingBuffer(RingBuffer const&) = delete;
+	RingBuffer& operator=(RingBuffer const&) = delete;
+
+	//producer side
+	bool push(T const& value)
+	{
+		auto currentHead = head.load(std::memory_order_relaxed);
+		if (currentHead - tail.load(std::memory_order_acquire) == Capacity) return false;
+
+		elements[currentHead & (Capacity - 1)] = value;
+		head.store(currentHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	//consumer side
+	View getView() const
+	{
+		return View(elements.data(), tail.load(std::memory_order_relaxed), head.load(std::memory_order_acquire));
+	}
+
+	void consume(View const& view)
+	{
+		tail.store(tail.load(std::memory_order_relaxed) + view.size(), std::memory_order_release);
+	}
+
+	static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+	std::array<T, Capacity> elements{};
+	alignas(64) std::atomic<std::size_t> head{};
+	alignas(64) std::atomic<std::size_t> tail{};
+};
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include "Solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static std::vector<double> convolve(std::vector<double> const& first, std::vector<double> const& second)
+{
+	std::vector<double> result(first.size() + second.size() - 1, 0.0);
+	for (std::size_t i = 0; i < first.size(); i++)
+	{
+		if (first[i] == 0.0) continue;
+		for (std::size_t j = 0; j < second.size(); j++)
+		{
+			result[i + j] += first[i] * second[j];
+		}
+	}
+	//only ratios matter, rescaling keeps long products of large counts inside double range
+	auto largest = *std::max_element(result.begin(), result.end());
+	if (largest > 0.0)
+	{
+		for (auto& value : result) value /= largest;
+	}
+	return result;
+}
+
+static double logChoose(double n, double k)
+{
+	return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+Solver::Solver(std::size_t threadCount)
+{
+	//the pool always keeps at least one worker, so no threads means no pool rather than a pool of one
+	if (threadCount > 0) threadPool.emplace(threadCount);
+}
+
+SolverResult Solver::solve(SolverInput const& input)
+{
+	auto cellCount = input.width * input.height;
+	std::vector<Knowledge> knowledge(cellCount, Knowledge::eUnknown);
+	auto constraints = propagateRules(input, knowledge);
+
+	auto components = findComponents(constraints, cellCount);
+	solveComponents(components);
+
+	SolverResult result;
+	result.mineProbabilities.assign(cellCount, 0.0f);
+
+	std::vector<bool> frontier(cellCount, false);
+	for (auto const& component : components)
+	{
+		for (auto cell : component.cells) frontier[cell] = true;
+		result.exact = result.exact && component.result->exact;
+	}
+
+	std::size_t knownMines = 0;
+	std::vector<std::size_t> restCells;
+	for (std::size_t cell = 0; cell < cellCount; cell++)
+	{
+		if (input.cells[cell] >= 0) continue;
+		if (knowledge[cell] == Knowledge::eMine) knownMines++;
+		else if (knowledge[cell] == Knowledge::eUnknown && !frontier[cell]) restCells.push_back(cell);
+	}
+
+	//every component's solutions are weighted by how many ways the cells off the frontier can hold the remaining mines
+	std::vector<std::vector<double>> distributions;
+	for (auto const& component : components)
+	{
+		auto const& ways = component.result->ways;
+		auto largest = *std::max_element(ways.begin(), ways.end());
+		std::vector<double> distribution(ways.size());
+		for (std::size_t k = 0; k < ways.size(); k++) distribution[k] = largest > 0.0 ? ways[k] / largest : 0.0;
+		distributions.push_back(std::move(distribution));
+	}
+
+	std::vector<std::vector<double>> prefixes{{1.0}};
+	for (auto const& distribution : distributions) prefixes.push_back(convolve(prefixes.back(), distribution));
+	std::vector<std::vector<double>> suffixes(distributions.size() + 1, std::vector<double>{1.0});
+	for (std::size_t i = distributions.size(); i-- > 0;) suffixes[i] = convolve(distributions[i], suffixes[i + 1]);
+
+	auto frontierCellCount = prefixes.back().size() - 1;
+	double remainingMines = input.mineCount ? std::max(0.0, double(*input.mineCount) - double(knownMines)) : 0.0;
+	double restCount = double(restCells.size());
+	std::vector<double> totalWeights(frontierCellCount + 1, 1.0);
+	if (input.mineCount)
+	{
+		std::vector<double> logWeights(frontierCellCount + 1, -INFINITY);
+		for (std::size_t k = 0; k <= frontierCellCount; k++)
+		{
+			double restMines = remainingMines - double(k);
+			if (restMines >= 0.0 && restMines <= restCount) logWeights[k] = logChoose(restCount, restMines);
+		}
+		auto largest = *std::max_element(logWeights.begin(), logWeights.end());
+		for (std::size_t k = 0; k <= frontierCellCount; k++)
+		{
+			totalWeights[k] = std::isinf(largest) ? 1.0 : std::exp(logWeights[k] - largest);
+		}
+	}
+
+	double density = std::clamp(input.mineDensity, 1e-6, 1.0 - 1e-6);
+	for (std::size_t c = 0; c < components.size(); c++)
+	{
+		auto const& componentResult = *components[c].result;
+		auto const& distribution = distributions[c];
+		auto largest = *std::max_element(componentResult.ways.begin(), componentResult.ways.end());
+
+		std::vector<double> factors(distribution.size(), 1.0);
+		if (input.mineCount)
+		{
+			auto rest = convolve(prefixes[c], suffixes[c + 1]);
+			for (std::size_t k = 0; k < factors.size(); k++)
+			{
+				factors[k] = 0.0;
+				for (std::size_t restK = 0; restK < rest.size() && k + restK < totalWeights.size(); restK++) factors[k] += rest[restK] * totalWeights[k + restK];
+			}
+		}
+		else
+		{
+			for (std::size_t k = 0; k < factors.size(); k++) factors[k] = std::pow(density / (1.0 - density), double(k));
+		}
+
+		double total = 0.0;
+		for (std::size_t k = 0; k < distribution.size(); k++) total += distribution[k] * factors[k];
+		//an inconsistent mine count leaves no weight, fall back to counting solutions alone
+		if (total <= 0.0)
+		{
+			std::fill(factors.begin(), factors.end(), 1.0);
+			total = std::accumulate(distribution.begin(), distribution.end(), 0.0);
+		}
+
+		for (std::size_t i = 0; i < components[c].cells.size(); i++)
+		{
+			double mineWeight = 0.0;
+			for (std::size_t k = 0; k < distribution.size(); k++)
+			{
+				if (largest > 0.0) mineWeight += componentResult.cellMines[i][k] / largest * factors[k];
+			}
+			auto probability = total > 0.0 ? mineWeight / total : 0.5;
+			auto cell = components[c].cells[i];
+			result.mineProbabilities[cell] = static_cast<float>(probability);
+			if (componentResult.exact && mineWeight == 0.0) knowledge[cell] = Knowledge::eSafe;
+			else if (componentResult.exact && probability > 1.0 - 1e-12) knowledge[cell] = Knowledge::eMine;
+		}
+	}
+
+	if (!restCells.empty())
+	{
+		double restProbability = density;
+		if (input.mineCount)
+		{
+			auto const& total = prefixes.back();
+			double weightSum = 0.0, expectedMines = 0.0;
+			for (std::size_t k = 0; k < total.size(); k++)
+			{
+				weightSum += total[k] * totalWeights[k];
+				expectedMines += total[k] * totalWeights[k] * std::max(0.0, remainingMines - double(k));
+			}
+			restProbability = weightSum > 0.0 ? std::min(expectedMines / weightSum / restCount, 1.0) : 0.5;
+		}
+		for (auto cell : restCells)
+		{
+			result.mineProbabilities[cell] = static_cast<float>(restProbability);
+			if (input.mineCount && result.exact && restProbability == 0.0) knowledge[cell] = Knowledge::eSafe;
+			else if (input.mineCount && result.exact && restProbability >= 1.0) knowledge[cell] = Knowledge::eMine;
+		}
+	}
+
+	for (std::size_t cell = 0; cell < cellCount; cell++)
+	{
+		if (knowledge[cell] == Knowledge::eSafe)
+		{
+			result.safeCells.push_back(cell);
+			result.mineProbabilities[cell] = 0.0f;
+		}
+		else if (knowledge[cell] == Knowledge::eMine)
+		{
+			result.mineCells.push_back(cell);
+			result.mineProbabilities[cell] = 1.0f;
+		}
+	}
+	return result;
+}
+
+SolverResult Solver::solveWithRules(SolverInput const& input)
+{
+	auto cellCount = input.width * input.height;
+	std::vector<Knowledge> knowledge(cellCount, Knowledge::eUnknown);
+	propagateRules(input, knowledge);
+
+	//with every mine accounted for the rest is safe, and with as many unknown cells as mines left they are all mines
+	if (input.mineCount)
+	{
+		std::size_t knownMines = 0, unknownCells = 0;
+		for (std::size_t cell = 0; cell < cellCount; cell++)
+		{
+			if (input.cells[cell] >= 0) continue;
+			if (knowledge[cell] == Knowledge::eMine) knownMines++;
+			else if (knowledge[cell] == Knowledge::eUnknown) unknownCells++;
+		}
+		if (unknownCells > 0 && (knownMines == *input.mineCount || unknownCells + knownMines == *input.mineCount))
+		{
+			auto value = knownMines == *input.mineCount ? Knowledge::eSafe : Knowledge::eMine;
+			for (std::size_t cell = 0; cell < cellCount; cell++)
+			{
+				if (input.cells[cell] < 0 && knowledge[cell] == Knowledge::eUnknown) knowledge[cell] = value;
+			}
+		}
+	}
+
+	SolverResult result;
+	for (std::size_t cell = 0; cell < cellCount; cell++)
+	{
+		if (knowledge[cell] == Knowledge::eSafe) result.safeCells.push_back(cell);
+		else if (knowledge[cell] == Knowledge::eMine) result.mineCells.push_back(cell);
+	}
+	return result;
+}
+
+std::vector<Solver::Constraint> Solver::propagateRules(SolverInput const& input, std::vector<Knowledge>& knowledge)
+{
+	auto constraints = buildConstraints(input);
+	while (true)
+	{
+		reduceConstraints(constraints, knowledge);
+		if (applySimpleRules(constraints, knowledge)) continue;
+		if (applySubsetRules(constraints, knowledge)) continue;
+		break;
+	}
+	return constraints;
+}
+
+std::vector<Solver::Constraint> Solver::buildConstraints(SolverInput const& input)
+{
+	std::vector<Constraint> constraints;
+	for (std::size_t y = 0; y < input.height; y++)
+	{
+		for (std::size_t x = 0; x < input.width; x++)
+		{
+			auto number = input.cells[y * input.width + x];
+			if (number < 0) continue;
+			if (input.openEdges && (x == 0 || y == 0 || x + 1 == input.width || y + 1 == input.height)) continue;
+
+			Constraint constraint{{}, number};
+			for (std::size_t adjacentY = y > 0 ? y - 1 : 0; adjacentY <= std::min(y + 1, input.height - 1); adjacentY++)
+			{
+				for (std::size_t adjacentX = x > 0 ? x - 1 : 0; adjacentX <= std::min(x + 1, input.width - 1); adjacentX++)
+				{
+					if (input.cells[adjacentY * input.width + adjacentX] < 0) constraint.cells.push_back(adjacentY * input.width + adjacentX);
+				}
+			}
+			if (!constraint.cells.empty()) constraints.push_back(std::move(constraint));
+		}
+	}
+	return constraints;
+}
+
+void Solver::reduceConstraints(std::vector<Constraint>& constraints, std::vector<Knowledge> const& knowledge)
+{
+	for (auto& constraint : constraints)
+	{
+		std::erase_if(constraint.cells, [&](std::size_t cell)
+			{
+				if (knowledge[cell] == Knowledge::eMine) constraint.mines--;
+				return knowledge[cell] != Knowledge::eUnknown;
+			});
+	}
+	std::erase_if(constraints, [](Constraint const& constraint) { return constraint.cells.empty(); });
+
+	std::sort(constraints.begin(), constraints.end(), [](Constraint const& first, Constraint const& second) { return first.cells < second.cells; });
+	constraints.erase(std::unique(constraints.begin(), constraints.end(),
+		[](Constraint const& first, Constraint const& second) { return first.cells == second.cells; }), constraints.end());
+}
+
+bool Solver::applySimpleRules(std::vector<Constraint> const& constraints, std::vector<Knowledge>& knowledge)
+{
+	bool changed = false;
+	for (auto const& constraint : constraints)
+	{
+		if (constraint.mines != 0 && constraint.mines != static_cast<int>(constraint.cells.size())) continue;
+
+		auto value = constraint.mines == 0 ? Knowledge::eSafe : Knowledge::eMine;
+		for (auto cell : constraint.cells)
+		{
+			if (knowledge[cell] == Knowledge::eUnknown)
+			{
+				knowledge[cell] = value;
+				changed = true;
+			}
+		}
+	}
+	return changed;
+}
+
+bool Solver::applySubsetRules(std::vector<Constraint> const& constraints, std::vector<Knowledge>& knowledge)
+{
+	//every superset of a constraint contains its first cell, so only constraints sharing that cell need checking
+	std::unordered_map<std::size_t, std::vector<std::size_t>> cellConstraints;
+	for (std::size_t i = 0; i < constraints.size(); i++)
+	{
+		for (auto cell : constraints[i].cells) cellConstraints[cell].push_back(i);
+	}
+
+	bool changed = false;
+	std::vector<std::size_t> difference;
+	for (auto const& subset : constraints)
+	{
+		for (auto supersetIndex : cellConstraints[subset.cells.front()])
+		{
+			auto const& superset = constraints[supersetIndex];
+			if (superset.cells.size() <= subset.cells.size()) continue;
+			if (!std::includes(superset.cells.begin(), superset.cells.end(), subset.cells.begin(), subset.cells.end())) continue;
+
+			difference.clear();
+			std::set_difference(superset.cells.begin(), superset.cells.end(), subset.cells.begin(), subset.cells.end(), std::back_inserter(difference));
+			int differenceMines = superset.mines - subset.mines;
+			if (differenceMines != 0 && differenceMines != static_cast<int>(difference.size())) continue;
+
+			auto value = differenceMines == 0 ? Knowledge::eSafe : Knowledge::eMine;
+			for (auto cell : difference)
+			{
+				if (knowledge[cell] == Knowledge::eUnknown)
+				{
+					knowledge[cell] = value;
+					changed = true;
+				}
+			}
+		}
+	}
+	return changed;
+}
+
+std::vector<Solver::Component> Solver::findComponents(std::vector<Constraint> const& constraints, std::size_t cellCount)
+{
+	std::vector<std::size_t> parents(constraints.size());
+	std::iota(parents.begin(), parents.end(), 0);
+	auto findRoot = [&](std::size_t index)
+	{
+		while (parents[index] != index) index = parents[index] = parents[parents[index]];
+		return index;
+	};
+
+	std::unordered_map<std::size_t, std::size_t> cellOwners;
+	for (std::size_t i = 0; i < constraints.size(); i++)
+	{
+		for (auto cell : constraints[i].cells)
+		{
+			auto [owner, inserted] = cellOwners.try_emplace(cell, i);
+			if (!inserted) parents[findRoot(i)] = findRoot(owner->second);
+		}
+	}
+
+	std::unordered_map<std::size_t, std::size_t> componentIndices;
+	std::vector<Component> components;
+	std::vector<uint32_t> localIndices(cellCount, UINT32_MAX);
+	for (std::size_t i = 0; i < constraints.size(); i++)
+	{
+		auto [found, inserted] = componentIndices.try_emplace(findRoot(i), components.size());
+		if (inserted) components.emplace_back();
+		auto& component = components[found->second];
+
+		//cells are numbered in order of first appearance, which makes the key independent of where the pattern sits on the board
+		Constraint localConstraint{{}, constraints[i].mines};
+		for (auto cell : constraints[i].cells)
+		{
+			if (localIndices[cell] == UINT32_MAX)
+			{
+				localIndices[cell] = static_cast<uint32_t>(component.cells.size());
+				component.cells.push_back(cell);
+			}
+			localConstraint.cells.push_back(localIndices[cell]);
+		}
+		component.key += std::to_string(localConstraint.mines) + ':';
+		for (auto cell : localConstraint.cells) component.key += std::to_string(cell) + ',';
+		component.key += ';';
+		component.constraints.push_back(std::move(localConstraint));
+	}
+	return components;
+}
+
+void Solver::solveComponents(std::vector<Component>& components)
+{
+	std::unordered_map<std::string, std::vector<std::size_t>> pending;
+	{
+		std::lock_guard lock(cacheMutex);
+		for (std::size_t i = 0; i < components.size(); i++)
+		{
+			if (auto found = cache.find(components[i].key); found != cache.end())
+			{
+				components[i].result = found->second;
+				cacheHits++;
+			}
+			else pending[components[i].key].push_back(i);
+		}
+	}
+	if (pending.empty()) return;
+
+	std::vector<std::pair<std::vector<std::size_t> const*, std::future<ComponentResult>>> tasks;
+	for (auto const& [key, indices] : pending)
+	{
+		auto const& component = components[indices.front()];
+		if (pending.size() == 1 || !threadPool)
+		{
+			std::promise<ComponentResult> result;
+			result.set_value(enumerateComponent(component));
+			tasks.emplace_back(&indices, result.get_future());
+		}
+		else tasks.emplace_back(&indices, threadPool->submit([&component]() { return enumerateComponent(component); }));
+	}
+
+	std::lock_guard lock(cacheMutex);
+	if (cache.size() + tasks.size() > SOLVER_CACHE_CAPACITY) cache.clear();
+	for (auto& [indices, future] : tasks)
+	{
+		auto result = std::make_shared<ComponentResult const>(future.get());
+		for (auto index : *indices) components[index].result = result;
+		cache.emplace(components[indices->front()].key, result);
+	}
+}
+
+Solver::ComponentResult Solver::enumerateComponent(Component const& component)
+{
+	auto cellCount = component.cells.size();
+	ComponentResult result;
+	result.ways.assign(cellCount + 1, 0.0);
+	result.cellMines.assign(cellCount, std::vector<double>(cellCount + 1, 0.0));
+
+	std::vector<std::vector<std::size_t>> cellConstraints(cellCount);
+	std::vector<int> assignedMines(component.constraints.size(), 0);
+	std::vector<int> unassignedCells(component.constraints.size());
+	for (std::size_t c = 0; c < component.constraints.size(); c++)
+	{
+		unassignedCells[c] = static_cast<int>(component.constraints[c].cells.size());
+		for (auto cell : component.constraints[c].cells) cellConstraints[cell].push_back(c);
+	}
+
+	std::vector<uint8_t> assignment(cellCount, 0);
+	uint64_t visitedNodes = 0;
+	auto visit = [&](auto& self, std::size_t cell, std::size_t mines) -> void
+	{
+		if (!result.exact) return;
+		if (++visitedNodes > SOLVER_MAX_SEARCH_NODES)
+		{
+			result.exact = false;
+			return;
+		}
+		if (cell == cellCount)
+		{
+			result.ways[mines] += 1.0;
+			for (std::size_t i = 0; i < cellCount; i++)
+			{
+				if (assignment[i]) result.cellMines[i][mines] += 1.0;
+			}
+			return;
+		}
+
+		for (uint8_t value = 0; value <= 1; value++)
+		{
+			bool valid = true;
+			for (auto c : cellConstraints[cell])
+			{
+				int assigned = assignedMines[c] + value;
+				if (assigned > component.constraints[c].mines || assigned + unassignedCells[c] - 1 < component.constraints[c].mines) valid = false;
+			}
+			if (!valid) continue;
+
+			for (auto c : cellConstraints[cell])
+			{
+				assignedMines[c] += value;
+				unassignedCells[c]--;
+			}
+			assignment[cell] = value;
+			self(self, cell + 1, mines + value);
+			assignment[cell] = 0;
+			for (auto c : cellConstraints[cell])
+			{
+				assignedMines[c] -= value;
+				unassignedCells[c]++;
+			}
+		}
+	};
+	visit(visit, 0, 0);
+
+	if (!result.exact)
+	{
+		//too many solutions to count, estimate every cell from the constraints it is part of
+		result.ways.assign(cellCount + 1, 0.0);
+		result.cellMines.assign(cellCount, std::vector<double>(cellCount + 1, 0.0));
+		std::vector<double> estimates(cellCount, 0.0);
+		double expectedMines = 0.0;
+		for (std::size_t cell = 0; cell < cellCount; cell++)
+		{
+			for (auto c : cellConstraints[cell]) estimates[cell] += double(component.constraints[c].mines) / component.constraints[c].cells.size();
+			estimates[cell] /= std::max<std::size_t>(cellConstraints[cell].size(), 1);
+			expectedMines += estimates[cell];
+		}
+		auto k = std::min(static_cast<std::size_t>(std::lround(expectedMines)), cellCount);
+		result.ways[k] = 1.0;
+		for (std::size_t cell = 0; cell < cellCount; cell++) result.cellMines[cell][k] = estimates[cell];
+	}
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gameConstants.h"
+#include "ThreadPool.h"
+
+//what the player can see of a board, row major, covered and marked cells or the number of a revealed cell
+struct SolverInput
+{
+	static constexpr int8_t COVERED = -1;
+	static constexpr int8_t MARKED = -2;
+
+	std::size_t width{};
+	std::size_t height{};
+	std::vector<int8_t> cells;
+	//total mines on the board, without it cells away from the frontier fall back to mineDensity
+	std::optional<std::size_t> mineCount;
+	double mineDensity = 0.0;
+	//the input is a window into a larger board, numbers on its edge have neighbours outside and are ignored
+	bool openEdges = false;
+};
+
+struct SolverResult
+{
+	std::vector<std::size_t> safeCells;
+	std::vector<std::size_t> mineCells;
+	//0 for revealed cells
+	std::vector<float> mineProbabilities;
+	//false when a frontier component was too large to enumerate and its probabilities are estimates
+	bool exact = true;
+};
+
+//marks are ignored, everything is derived from the revealed numbers
+//single cell and subset rules run first, the remaining frontier is split into independent components which are enumerated exactly
+//on the thread pool, component results are memoised by their shape so repeated patterns are only counted once
+class Solver
+{
+	struct Constraint
+	{
+		std::vector<std::size_t> cells;
+		int mines;
+	};
+	struct ComponentResult
+	{
+		//ways[k] is the number of solutions with k mines, cellMines[cell][k] how many of those have a mine in cell
+		std::vector<double> ways;
+		std::vector<std::vector<double>> cellMines;
+		bool exact = true;
+	};
+	struct Component
+	{
+		std::vector<std::size_t> cells;
+		std::vector<Constraint> constraints;
+		std::string key;
+		std::shared_ptr<ComponentResult const> result;
+	};
+
+public:
+	//with zero threads no pool is created and every component is enumerated on the calling thread, for callers that already run one solver per core
+	explicit Solver(std::size_t threadCount = std::thread::hardware_concurrency());
+
+	SolverResult solve(SolverInput const& input);
+	//single cell, subset and mine count rules only, single threaded and without probabilities
+	static SolverResult solveWithRules(SolverInput const& input);
+
+	std::size_t getCacheSize() const { return cache.size(); }
+	uint64_t getCacheHits() const { return cacheHits; }
+
+private:
+	enum class Knowledge : uint8_t
+	{
+		eUnknown, eSafe, eMine
+	};
+
+	static std::vector<Constraint> propagateRules(SolverInput const& input, std::vector<Knowledge>& knowledge);
+	static std::vector<Constraint> buildConstraints(SolverInput const& input);
+	static void reduceConstraints(std::vector<Constraint>& constraints, std::vector<Knowledge> const& knowledge);
+	static bool applySimpleRules(std::vector<Constraint> const& constraints, std::vector<Knowledge>& knowledge);
+	static bool applySubsetRules(std::vector<Constraint> const& constraints, std::vector<Knowledge>& knowledge);
+	static std::vector<Component> findComponents(std::vector<Constraint> const& constraints, std::size_t cellCount);
+	void solveComponents(std::vector<Component>& components);
+	static ComponentResult enumerateComponent(Component const& component);
+
+	std::optional<ThreadPool> threadPool;
+	std::mutex cacheMutex;
+	std::unordered_map<std::string, std::shared_ptr<ComponentResult const>> cache;
+	uint64_t cacheHits{};
+};
\ No newline at end of file
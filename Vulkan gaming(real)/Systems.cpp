@@ -0,0 +1,54 @@
+#include "Systems.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include "Components.h"
+
+static_assert(MAX_TRANSFORM_GROUPS <= 1 << 16, "transform groups are packed into 16 bits");
+
+//positions and scales outside of INSTANCE_COORDINATE_RANGE are clamped
+static PackedInstance packInstance(Transform const& transform, Tint const& tint, GlyphRegion const& region)
+{
+	return PackedInstance{glm::packUnorm4x8(tint.color), glm::packSnorm2x16(glm::vec2(transform.position) / INSTANCE_COORDINATE_RANGE),
+		glm::packUnorm2x16(transform.scale / INSTANCE_COORDINATE_RANGE), transform.position.z, region.glyph | transform.group << 16};
+}
+
+std::size_t extractQuadInstances(EntityWorld& world, PackedInstance* instances, std::size_t capacity, ThreadPool* threadPool)
+{
+	auto extract = [instances, capacity](std::size_t index, Transform const& transform, Tint const& tint, GlyphRegion const& region)
+	{
+		if (index < capacity) instances[index] = packInstance(transform, tint, region);
+	};
+
+	if (threadPool)
+	{
+		world.parallelForEach<Transform, Tint, GlyphRegion>(*threadPool, extract);
+	}
+	else
+	{
+		std::size_t index = 0;
+		world.forEach<Transform, Tint, GlyphRegion>([&](Entity, Transform const& transform, Tint const& tint, GlyphRegion const& region)
+			{
+				extract(index++, transform, tint, region);
+			});
+	}
+	return std::min(world.count<Transform, Tint, GlyphRegion>(), capacity);
+}
+
+void updateLifetimes(EntityWorld& world, double deltaTime, ThreadPool* threadPool)
+{
+	auto advance = [deltaTime](std::size_t, Lifetime& lifetime) { lifetime.elapsed += deltaTime; };
+	if (threadPool) world.parallelForEach<Lifetime>(*threadPool, advance);
+	else world.forEach<Lifetime>([&](Entity, Lifetime& lifetime) { advance(0, lifetime); });
+
+	//destroying restructures the world, so expired entities are only collected while iterating
+	std::vector<Entity> expired;
+	world.forEach<Lifetime>([&](Entity entity, Lifetime const& lifetime)
+		{
+			if (lifetime.elapsed >= lifetime.duration) expired.push_back(entity);
+		});
+	for (auto entity : expired)
+	{
+		world.destroy(entity);
+	}
+}
\ No newline at end of file
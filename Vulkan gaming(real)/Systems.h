@@ -0,0 +1,10 @@
+#pragma once
+
+#include "constants.h"
+#include "EntityWorld.h"
+
+//packs every entity with a transform, tint and glyph region into one instance, returns how many were written
+//the batches run on threadPool when one is given
+std::size_t extractQuadInstances(EntityWorld& world, PackedInstance* instances, std::size_t capacity, ThreadPool* threadPool = nullptr);
+//advances every lifetime and destroys the entities whose lifetime ran out, the advancing runs on threadPool when one is given
+void updateLifetimes(EntityWorld& world, double deltaTime, ThreadPool* threadPool = nullptr);
\ No newline at end of file
@@ -1,9 +1,9 @@
 #include "Text.h"
 
-#include "ObjectPool.h"
+#include "Components.h"
 
-Text::Text(std::string const& text, Font const& font, glm::vec3 const& position)
-	:position(position), font(font), text(text)
+Text::Text(std::string const& text, Font const& font, glm::vec3 const& position, uint32_t parentGroup)
+	:font(font), text(text), group(GameWorld::transformGroups.create(position, parentGroup))
 {
 	addQuads();
 }
@@ -11,15 +11,12 @@ Text::Text(std::string const& text, Font const& font, glm::vec3 const& position)
 Text::~Text()
 {
 	clearQuads();
+	GameWorld::transformGroups.destroy(group);
 }
 
 void Text::shift(glm::vec3 const& shift)
 {
-	for (auto quad : letterQuads)
-	{
-		auto quadData = ObjectPools::quads.data() + quad;
-		quadData->setPosition(quadData->getPosition() + shift);
-	}
+	GameWorld::transformGroups.move(group, shift);
 }
 
 void Text::setText(std::string const& newText)
@@ -33,51 +30,63 @@ void Text::clearQuads()
 {
 	for (auto quad : letterQuads)
 	{
-		ObjectPools::quads.remove(quad);
+		GameWorld::entities.destroy(quad);
 	}
 	letterQuads.clear();
+
+	for (auto glyph : letterGlyphs)
+	{
+		font.releaseGlyph(glyph);
+	}
+	letterGlyphs.clear();
 }
 
 void Text::addQuads()
 {
 	letterQuads.reserve(text.size());
-	auto currentX = position.x;
+	letterGlyphs.reserve(text.size());
+	auto currentX = 0.0f;
 	uint32_t cellXCount = font.bitmapWidth / font.cellWidth;
 	uint32_t cellYCount = font.bitmapHeight / font.cellHeight;
-	for (unsigned char c : text)
+	for (std::size_t i = 0; i < text.size();)
 	{
-		letterQuads.push_back(0);
-		ObjectPools::quads.add(QuadComponent(glm::vec3(currentX, position.y, position.z),
-			glm::vec2(font.scale * font.cellWidth / font.cellHeight, font.scale),
-			font.getCharOffset(c), font.getCharTextureScale()),
-			&letterQuads[letterQuads.size() - 1]);
+		auto glyph = font.acquireGlyph(decodeUtf8(text, i));
+		letterGlyphs.push_back(glyph);
+		letterQuads.push_back(GameWorld::entities.create(
+			Transform{glm::vec3(currentX, 0.0f, 0.0f), glm::vec2(font.scale * font.cellWidth / font.cellHeight, font.scale), group},
+			Tint{}, GlyphRegion{glyph}));
 		currentX += font.scale * font.cellWidth / font.cellHeight;
 	}
 }
 
 TextBox::TextBox(glm::vec3 const& position, glm::vec2 const& size, Font const& font)
-	:position(position), size(size), font(font)
+	:size(size), font(font), group(GameWorld::transformGroups.create(position))
 {}
 
+TextBox::~TextBox()
+{
+	contents.clear();
+	GameWorld::transformGroups.destroy(group);
+}
+
 void TextBox::addText(std::string const& text, uint64_t lifetime)
 {
 	uint64_t rowChars = static_cast<uint64_t>(size.x / (font.scale * font.cellWidth / font.cellHeight));
-	uint64_t currentCharIndex = 0;
-	while (currentCharIndex < text.size())
+	std::size_t rowStart = 0;
+	std::size_t currentIndex = 0;
+	uint64_t currentRowChars = 0;
+	while (currentIndex < text.size())
 	{
-		glm::vec3 rowPosition = glm::vec3(position.x, position.y + currentRow * font.scale, position.z);
-		if (currentCharIndex + rowChars > text.size())
-		{
-			contents.push_back(Pair{std::make_unique<Text>(std::string(text.begin() + currentCharIndex, text.end()), font, rowPosition), lifetime});
-			currentCharIndex = text.size();
-		}
-		else
+		decodeUtf8(text, currentIndex);
+		currentRowChars++;
+		if (currentRowChars == rowChars || currentIndex >= text.size())
 		{
-			contents.push_back(Pair{std::make_unique<Text>(std::string(text.begin() + currentCharIndex, text.begin() + currentCharIndex + rowChars), font, rowPosition),
-									lifetime});
-			currentCharIndex += rowChars;
+			glm::vec3 rowPosition = glm::vec3(0.0f, currentRow * font.scale, 0.0f);
+			contents.push_back(Pair{std::make_unique<Text>(std::string(text.begin() + rowStart, text.begin() + currentIndex), font, rowPosition, group), lifetime});
+			rowStart = currentIndex;
+			currentRowChars = 0;
+			currentRow++;
 		}
-		currentRow++;
 	}
 }
 
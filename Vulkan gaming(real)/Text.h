@@ -2,13 +2,14 @@
 
 #include "constants.h"
 #include "helpers.h"
-#include "QuadComponent.h"
+#include "EntityWorld.h"
 #include "Font.h"
 
 class Text
 {
 public:
-	Text(std::string const& text, Font const& font, glm::vec3 const& position);
+	//letters are placed in their own transform group at position inside parentGroup
+	Text(std::string const& text, Font const& font, glm::vec3 const& position, uint32_t parentGroup = TransformGroups::ROOT);
 	~Text();
 
 	void shift(glm::vec3 const& shift);
@@ -20,17 +21,19 @@ private:
 	void clearQuads();
 	void addQuads();
 
-	glm::vec3 position;
-
 	Font font;
 	std::string text;
-	std::vector<std::size_t> letterQuads;
+	uint32_t group;
+	std::vector<Entity> letterQuads;
+	//what acquireGlyph returned for each letter, released as is
+	std::vector<uint16_t> letterGlyphs;
 };
 
 class TextBox
 {
 public:
 	TextBox(glm::vec3 const& position, glm::vec2 const& size, Font const& font);
+	~TextBox();
 
 	void addText(std::string const& text, uint64_t lifetime);
 	void update();
@@ -40,7 +43,8 @@ private:
 	uint64_t currentRow = 0;
 
 	std::vector<Pair<std::unique_ptr<Text>, uint64_t>> contents;
-	glm::vec3 position;
 	glm::vec2 size;
 	Font font;
+	//rows are positioned inside it
+	uint32_t group;
 };
\ No newline at end of file
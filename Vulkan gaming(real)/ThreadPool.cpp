@@ -0,0 +1,164 @@
+#include "ThreadPool.h"
+
+#include <chrono>
+
+static constexpr std::size_t NO_WORKER = std::numeric_limits<std::size_t>::max();
+
+//lets a job find the deque of the worker it runs on
+static thread_local ThreadPool const* currentPool = nullptr;
+static thread_local std::size_t currentWorker = NO_WORKER;
+//jobs run while waiting inside another job are already covered by the outer job's busy time
+static thread_local std::size_t jobDepth = 0;
+
+static int64_t getNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+	:statisticsStart(getNanoseconds())
+{
+	threadCount = std::max<std::size_t>(threadCount, 1);
+	workerData.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; i++)
+	{
+		workerData.push_back(std::make_unique<Worker>());
+	}
+	workers.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back([this, i](std::stop_token stopToken) { workerLoop(stopToken, i); });
+	}
+}
+
+//jobs still queued when the pool goes away are dropped without running
+ThreadPool::~ThreadPool()
+{
+	workers.clear();
+	for (auto& worker : workerData)
+	{
+		while (auto job = worker->jobs.pop()) delete job;
+	}
+	for (auto job : sharedJobs)
+	{
+		delete job;
+	}
+}
+
+std::vector<ThreadPool::WorkerStatistics> ThreadPool::getWorkerStatistics() const
+{
+	auto elapsed = getNanoseconds() - statisticsStart.load(std::memory_order_relaxed);
+	std::vector<WorkerStatistics> statistics;
+	statistics.reserve(workerData.size());
+	for (auto const& worker : workerData)
+	{
+		auto busy = static_cast<double>(worker->busyNanoseconds.load(std::memory_order_relaxed));
+		statistics.push_back(WorkerStatistics{elapsed > 0 ? busy / elapsed : 0.0, worker->executedJobs.load(std::memory_order_relaxed),
+			worker->stolenJobs.load(std::memory_order_relaxed)});
+	}
+	return statistics;
+}
+
+void ThreadPool::resetWorkerStatistics()
+{
+	for (auto& worker : workerData)
+	{
+		worker->busyNanoseconds.store(0, std::memory_order_relaxed);
+		worker->executedJobs.store(0, std::memory_order_relaxed);
+		worker->stolenJobs.store(0, std::memory_order_relaxed);
+	}
+	statisticsStart.store(getNanoseconds(), std::memory_order_relaxed);
+}
+
+void ThreadPool::enqueue(Job* job)
+{
+	if (currentPool != this || !workerData[currentWorker]->jobs.push(job))
+	{
+		std::lock_guard lock(mutex);
+		sharedJobs.push_back(job);
+	}
+
+	//pairs with the sleeping worker checking queuedJobs after announcing itself, one of the two always sees the other
+	queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+	if (sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard lock(mutex);
+		condition.notify_one();
+	}
+}
+
+bool ThreadPool::runPendingJob()
+{
+	auto workerIndex = currentPool == this ? currentWorker : NO_WORKER;
+	auto job = findJob(workerIndex);
+	if (!job) return false;
+
+	runJob(job, workerIndex);
+	return true;
+}
+
+//own deque first, then the shared queue, then the other workers starting after this one
+ThreadPool::Job* ThreadPool::findJob(std::size_t workerIndex)
+{
+	if (queuedJobs.load(std::memory_order_acquire) == 0) return nullptr;
+
+	Job* job = nullptr;
+	if (workerIndex != NO_WORKER) job = workerData[workerIndex]->jobs.pop();
+	if (!job)
+	{
+		std::lock_guard lock(mutex);
+		if (!sharedJobs.empty())
+		{
+			job = sharedJobs.front();
+			sharedJobs.pop_front();
+		}
+	}
+	for (std::size_t i = 1; !job && i <= workerData.size(); i++)
+	{
+		auto victim = (workerIndex == NO_WORKER ? i - 1 : workerIndex + i) % workerData.size();
+		if (victim == workerIndex) continue;
+		job = workerData[victim]->jobs.steal();
+		if (job && workerIndex != NO_WORKER) workerData[workerIndex]->stolenJobs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (job) queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void ThreadPool::runJob(Job* job, std::size_t workerIndex)
+{
+	auto start = getNanoseconds();
+	jobDepth++;
+	job->function();
+	jobDepth--;
+	if (job->pending) job->pending->fetch_sub(1, std::memory_order_release);
+	delete job;
+
+	if (workerIndex == NO_WORKER) return;
+	auto& worker = *workerData[workerIndex];
+	if (jobDepth == 0) worker.busyNanoseconds.fetch_add(static_cast<uint64_t>(getNanoseconds() - start), std::memory_order_relaxed);
+	worker.executedJobs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::workerLoop(std::stop_token stopToken, std::size_t workerIndex)
+{
+	currentPool = this;
+	currentWorker = workerIndex;
+	while (!stopToken.stop_requested())
+	{
+		if (runPendingJob()) continue;
+
+		std::unique_lock lock(mutex);
+		sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+		condition.wait(lock, stopToken, [this]() { return queuedJobs.load(std::memory_order_seq_cst) > 0; });
+		sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+void TaskGroup::wait()
+{
+	while (pending.load(std::memory_order_acquire) > 0)
+	{
+		if (!threadPool.runPendingJob()) std::this_thread::yield();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gameConstants.h"
+#include "WorkStealingDeque.h"
+
+//fixed set of worker threads, each with its own deque of jobs that idle workers steal from
+//jobs started on a worker go to its own deque, jobs from any other thread go through a shared queue
+//submit returns a future for the task's result, TaskGroup and parallelFor fork work and join on it while helping to run jobs
+class ThreadPool
+{
+	struct Job
+	{
+		std::function<void()> function;
+		std::atomic<std::size_t>* pending;
+	};
+	struct alignas(64) Worker
+	{
+		WorkStealingDeque<Job*, WORK_STEALING_DEQUE_CAPACITY> jobs;
+		std::atomic<uint64_t> busyNanoseconds{};
+		std::atomic<uint64_t> executedJobs{};
+		std::atomic<uint64_t> stolenJobs{};
+	};
+
+public:
+	struct WorkerStatistics
+	{
+		//fraction of the time since the last reset spent running jobs
+		double utilisation;
+		uint64_t executedJobs;
+		uint64_t stolenJobs;
+	};
+
+	explicit ThreadPool(std::size_t threadCount);
+	~ThreadPool();
+
+	template<class Function>
+	auto submit(Function&& function)
+	{
+		using Result = std::invoke_result_t<Function>;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		auto future = task->get_future();
+		enqueue(new Job{[task]() { (*task)(); }, nullptr});
+		return future;
+	}
+
+	std::size_t getThreadCount() const { return workers.size(); }
+	std::vector<WorkerStatistics> getWorkerStatistics() const;
+	void resetWorkerStatistics();
+
+private:
+	friend class TaskGroup;
+
+	void enqueue(Job* job);
+	//runs one queued job on the calling thread, returns false when none could be found
+	bool runPendingJob();
+	Job* findJob(std::size_t workerIndex);
+	void runJob(Job* job, std::size_t workerIndex);
+	void workerLoop(std::stop_token stopToken, std::size_t workerIndex);
+
+	std::vector<std::unique_ptr<Worker>> workerData;
+	std::deque<Job*> sharedJobs;
+	std::atomic<std::size_t> queuedJobs{};
+	std::atomic<std::size_t> sleepingWorkers{};
+	std::atomic<int64_t> statisticsStart;
+	std::mutex mutex;
+	std::condition_variable_any condition;
+	//declared last so the workers are stopped and joined before the queues go away
+	std::vector<std::jthread> workers;
+};
+
+//jobs forked with run are joined by wait, the waiting thread runs queued jobs in the meantime instead of blocking
+class TaskGroup
+{
+public:
+	explicit TaskGroup(ThreadPool& threadPool)
+		:threadPool(threadPool)
+	{}
+	TaskGroup(TaskGroup const&) = delete;
+	~TaskGroup() { wait(); }
+
+	template<class Function>
+	void run(Function&& function)
+	{
+		pending.fetch_add(1, std::memory_order_relaxed);
+		threadPool.enqueue(new ThreadPool::Job{std::forward<Function>(function), &pending});
+	}
+	void wait();
+
+private:
+	ThreadPool& threadPool;
+	std::atomic<std::size_t> pending{};
+};
+
+//calls function(rangeBegin, rangeEnd) over [begin, end) split into ranges of grainSize, the calling thread takes the last range itself
+template<class Function>
+void parallelFor(ThreadPool& threadPool, std::size_t begin, std::size_t end, std::size_t grainSize, Function const& function)
+{
+	grainSize = std::max<std::size_t>(grainSize, 1);
+	TaskGroup group(threadPool);
+	for (auto rangeBegin = begin; rangeBegin < end; rangeBegin += grainSize)
+	{
+		auto rangeEnd = std::min(rangeBegin + grainSize, end);
+		if (rangeEnd == end) function(rangeBegin, rangeEnd);
+		else group.run([&function, rangeBegin, rangeEnd]() { function(rangeBegin, rangeEnd); });
+	}
+	group.wait();
+}
\ No newline at end of file
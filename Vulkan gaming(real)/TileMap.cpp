@@ -0,0 +1,65 @@
+#include "TileMap.h"
+
+TileMap::TileMap(uint32_t width, uint32_t height, float depth, Font const& font)
+	:width(width), height(height), depth(depth), font(font), tiles(width, height, 0), chunkDirty(tiles.getChunkCount(), false)
+{
+	palette.fill(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+	setVisibleRect({0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)});
+	fill(0);
+}
+
+void TileMap::setTile(std::size_t x, std::size_t y, uint8_t glyph)
+{
+	auto& tile = tiles(x, y);
+	if (tile == glyph) return;
+
+	tile = glyph;
+	markChunkDirty(tiles.getChunkIndex(x, y));
+}
+
+void TileMap::fill(uint8_t glyph)
+{
+	tiles.fill(glyph);
+	for (std::size_t chunk = 0; chunk < tiles.getChunkCount(); chunk++)
+	{
+		markChunkDirty(chunk);
+	}
+}
+
+void TileMap::setVisibleRect(glm::vec4 const& rect)
+{
+	glm::vec2 boardSize{static_cast<float>(width), static_cast<float>(height)};
+	auto rectBegin = glm::clamp(glm::vec2(rect.x, rect.y), glm::vec2(0.0f), boardSize);
+	auto rectEnd = glm::clamp(glm::vec2(rect.z, rect.w), glm::vec2(0.0f), boardSize);
+	visibleRect = {rectBegin, rectEnd};
+
+	glm::uvec2 chunkBegin = glm::uvec2(rectBegin) / BOARD_CHUNK_SIZE;
+	glm::uvec2 chunkEnd = (glm::uvec2(glm::ceil(rectEnd)) + BOARD_CHUNK_SIZE - 1u) / BOARD_CHUNK_SIZE;
+	visibleChunks = {chunkBegin, chunkEnd};
+}
+
+TileMapPushConstants TileMap::getPushConstants() const
+{
+	auto atlasWidth = font.glyphCache->getWidth();
+	auto atlasHeight = font.glyphCache->getHeight();
+	return {glm::vec4(visibleRect.x, visibleRect.y, visibleRect.z - visibleRect.x, visibleRect.w - visibleRect.y),
+		glm::vec2((float)font.cellWidth / atlasWidth, (float)font.cellHeight / atlasHeight), font.getCharTextureScale(), glm::uvec2(width, height),
+		atlasWidth / font.cellWidth, font.startChar, static_cast<uint32_t>(tiles.getChunkCountX()), depth};
+}
+
+void TileMap::clearDirtyChunks()
+{
+	for (auto chunk : dirtyChunks)
+	{
+		chunkDirty[chunk] = false;
+	}
+	dirtyChunks.clear();
+}
+
+void TileMap::markChunkDirty(std::size_t chunk)
+{
+	if (chunkDirty[chunk]) return;
+
+	chunkDirty[chunk] = true;
+	dirtyChunks.push_back(chunk);
+}
\ No newline at end of file
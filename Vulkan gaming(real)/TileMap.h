@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "constants.h"
+#include "ChunkedGrid.h"
+#include "Font.h"
+
+//grid of one byte glyph codes drawn as a single quad in board space, the fragment shader looks up each cell's glyph in the font atlas and its color in the palette
+//tiles are stored chunk by chunk, changing a cell marks its chunk dirty and the renderer only uploads dirty chunks inside the visible range
+class TileMap
+{
+public:
+	static constexpr std::size_t CHUNK_BYTES = ChunkedGrid<uint8_t>::CHUNK_AREA;
+
+	TileMap(uint32_t width, uint32_t height, float depth, Font const& font);
+
+	void setTile(std::size_t x, std::size_t y, uint8_t glyph);
+	void fill(uint8_t glyph);
+	void setPaletteColor(uint8_t glyph, glm::vec4 const& color) { palette[glyph] = color; }
+	void setVisibleRect(glm::vec4 const& rect);
+
+	uint8_t const* getTiles() const { return tiles.getData(); }
+	std::size_t getTileBufferSize() const { return tiles.getStorageSize(); }
+	std::size_t getChunkCount() const { return tiles.getChunkCount(); }
+	std::size_t getChunkCountX() const { return tiles.getChunkCountX(); }
+	std::array<glm::vec4, 256> const& getPalette() const { return palette; }
+	TileMapPushConstants getPushConstants() const;
+
+	//first and one past last visible chunk along x and y
+	glm::uvec4 const& getVisibleChunks() const { return visibleChunks; }
+	std::vector<std::size_t> const& getDirtyChunks() const { return dirtyChunks; }
+	void clearDirtyChunks();
+
+private:
+	void markChunkDirty(std::size_t chunk);
+
+	uint32_t width;
+	uint32_t height;
+	float depth;
+	Font font;
+
+	ChunkedGrid<uint8_t> tiles;
+	std::array<glm::vec4, 256> palette;
+	glm::vec4 visibleRect;
+	glm::uvec4 visibleChunks;
+	std::vector<std::size_t> dirtyChunks;
+	std::vector<bool> chunkDirty;
+};
\ No newline at end of file
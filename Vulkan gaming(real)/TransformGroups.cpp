@@ -0,0 +1,68 @@
+#include "TransformGroups.h"
+
+#include "logging.h"
+
+TransformGroups::TransformGroups()
+{
+	groups[ROOT] = Group{glm::vec3(0.0f), glm::vec2(1.0f), NO_PARENT, true};
+	usedCount = 1;
+}
+
+uint32_t TransformGroups::create(glm::vec3 const& offset, uint32_t parent, glm::vec2 const& scale)
+{
+	uint32_t group;
+	if (!freeGroups.empty())
+	{
+		group = freeGroups.back();
+		freeGroups.pop_back();
+	}
+	else
+	{
+		errorFatal(usedCount < MAX_TRANSFORM_GROUPS, "out of transform groups, raise MAX_TRANSFORM_GROUPS"s);
+		group = static_cast<uint32_t>(usedCount++);
+	}
+
+	groups[group] = Group{offset, scale, parent, true};
+	version++;
+	return group;
+}
+
+void TransformGroups::destroy(uint32_t group)
+{
+	if (group == ROOT || !groups[group].alive) return;
+
+	groups[group].alive = false;
+	freeGroups.push_back(group);
+}
+
+void TransformGroups::setOffset(uint32_t group, glm::vec3 const& offset)
+{
+	groups[group].offset = offset;
+	version++;
+}
+
+void TransformGroups::setScale(uint32_t group, glm::vec2 const& scale)
+{
+	groups[group].scale = scale;
+	version++;
+}
+
+GroupTransform TransformGroups::getWorldTransform(uint32_t group) const
+{
+	auto offset = groups[group].offset;
+	auto scale = groups[group].scale;
+	for (auto parent = groups[group].parent; parent != NO_PARENT; parent = groups[parent].parent)
+	{
+		offset = glm::vec3(glm::vec2(offset) * groups[parent].scale, offset.z) + groups[parent].offset;
+		scale *= groups[parent].scale;
+	}
+	return GroupTransform{glm::vec4(offset, 0.0f), glm::vec4(scale, 1.0f, 1.0f)};
+}
+
+void TransformGroups::resolve(GroupTransform* target) const
+{
+	for (uint32_t group = 0; group < usedCount; group++)
+	{
+		if (groups[group].alive) target[group] = getWorldTransform(group);
+	}
+}
\ No newline at end of file
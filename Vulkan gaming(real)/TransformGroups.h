@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "constants.h"
+
+//offset and scale shared by every quad in a group, optionally relative to a parent group
+//the vertex shader applies the resolved transforms, so moving a group is a single write no matter how many quads it holds
+//group 0 is the identity root every other group ends up under
+class TransformGroups
+{
+	struct Group
+	{
+		glm::vec3 offset;
+		glm::vec2 scale;
+		uint32_t parent;
+		bool alive;
+	};
+
+public:
+	static constexpr uint32_t ROOT = 0;
+	static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+	TransformGroups();
+
+	uint32_t create(glm::vec3 const& offset, uint32_t parent = ROOT, glm::vec2 const& scale = {1.0f, 1.0f});
+	void destroy(uint32_t group);
+
+	glm::vec3 getOffset(uint32_t group) const { return groups[group].offset; }
+	void setOffset(uint32_t group, glm::vec3 const& offset);
+	void move(uint32_t group, glm::vec3 const& delta) { setOffset(group, groups[group].offset + delta); }
+	void setScale(uint32_t group, glm::vec2 const& scale);
+
+	//transform of the group after applying all of its parents
+	GroupTransform getWorldTransform(uint32_t group) const;
+
+	//writes the world transforms of every group slot in use, indexed by group
+	void resolve(GroupTransform* target) const;
+	std::size_t getUsedCount() const { return usedCount; }
+	//changes whenever any group changed, lets each frame skip the upload when nothing moved
+	uint64_t getVersion() const { return version; }
+
+private:
+	std::array<Group, MAX_TRANSFORM_GROUPS> groups{};
+	std::vector<uint32_t> freeGroups;
+	std::size_t usedCount{};
+	uint64_t version{};
+};
\ No newline at end of file
@@ -2,8 +2,12 @@
 
 #include <unordered_set>
 #include <chrono>
-#include <stb_image.h>
 
+#include "Font.h"
+#include "GlyphCache.h"
+#include "TileMap.h"
+#include "Camera.h"
+#include "Systems.h"
 #include "helpers.h"
 #include "logging.h"
 #include "print.h"
@@ -480,7 +484,13 @@ auto VulkanResources::createDescriptorSetLayout()
 
 	vk::DescriptorSetLayoutBinding samplerLayoutBinding{1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment};
 
-	std::vector bindings{uboLayoutBinding, samplerLayoutBinding};
+	vk::DescriptorSetLayoutBinding transformGroupLayoutBinding{2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex};
+
+	vk::DescriptorSetLayoutBinding instanceLayoutBinding{3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex};
+
+	vk::DescriptorSetLayoutBinding glyphTableLayoutBinding{4, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex};
+
+	std::vector bindings{uboLayoutBinding, samplerLayoutBinding, transformGroupLayoutBinding, instanceLayoutBinding, glyphTableLayoutBinding};
 
 	vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{{}, bindings};
 	return errorFatal(device->createDescriptorSetLayoutUnique(layoutCreateInfo));
@@ -492,10 +502,30 @@ auto VulkanResources::createGraphicsPipelineLayout()
 	return errorFatal(device->createPipelineLayoutUnique(layoutCreateInfo), "couldn't create pipeline layout"s);
 }
 
-auto VulkanResources::createGraphicsPipeline(vk::Extent2D viewportExtent, vk::RenderPass renderPass, vk::PolygonMode polygonMode)
+auto VulkanResources::createTileMapDescriptorSetLayout()
+{
+	vk::DescriptorSetLayoutBinding tileLayoutBinding{0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment};
+
+	vk::DescriptorSetLayoutBinding paletteLayoutBinding{1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eFragment};
+
+	std::vector bindings{tileLayoutBinding, paletteLayoutBinding};
+
+	vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{{}, bindings};
+	return errorFatal(device->createDescriptorSetLayoutUnique(layoutCreateInfo), "couldn't create tile map descriptor set layout"s);
+}
+
+auto VulkanResources::createTileMapPipelineLayout()
 {
-	auto vertexShaderCode = readFile("shaders/vertex.spv");
-	auto fragmentShaderCode = readFile("shaders/fragment.spv");
+	std::vector setLayouts{descriptorSetLayout.get(), tileMapDescriptorSetLayout.get()};
+	vk::PushConstantRange pushConstantRange{vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(TileMapPushConstants)};
+	vk::PipelineLayoutCreateInfo layoutCreateInfo{{}, setLayouts, pushConstantRange};
+	return errorFatal(device->createPipelineLayoutUnique(layoutCreateInfo), "couldn't create tile map pipeline layout"s);
+}
+
+auto VulkanResources::createGraphicsPipeline(vk::Extent2D viewportExtent, vk::RenderPass renderPass, vk::PolygonMode polygonMode, bool tileMapPipeline)
+{
+	auto vertexShaderCode = readFile(tileMapPipeline ? "shaders/tilemapVertex.spv" : "shaders/vertex.spv");
+	auto fragmentShaderCode = readFile(tileMapPipeline ? "shaders/tilemapFragment.spv" : "shaders/fragment.spv");
 	errorFatal(!vertexShaderCode.empty() && !fragmentShaderCode.empty(), "couldn't read shader files"s);
 
 	vk::UniqueShaderModule vertexShaderModule = createShaderModule(vertexShaderCode);
@@ -504,7 +534,12 @@ auto VulkanResources::createGraphicsPipeline(vk::Extent2D viewportExtent, vk::Re
 	formatPrint(std::cout, "Created fragment shader module\n"sv);
 
 	vk::PipelineShaderStageCreateInfo vertexShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eVertex, vertexShaderModule.get(), "main"};
-	vk::PipelineShaderStageCreateInfo fragmentShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eFragment, fragmentShaderModule.get(), "main"};
+	vk::Bool32 distanceField = glyphCache->isDistanceField();
+	vk::SpecializationMapEntry specializationMapEntry{0, 0, sizeof(distanceField)};
+	vk::SpecializationInfo specializationInfo{1, &specializationMapEntry, sizeof(distanceField), &distanceField};
+
+	vk::PipelineShaderStageCreateInfo fragmentShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eFragment, fragmentShaderModule.get(), "main",
+		&specializationInfo};
 
 	std::vector<vk::PipelineShaderStageCreateInfo> shaderStages{vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo};
 
@@ -512,11 +547,8 @@ auto VulkanResources::createGraphicsPipeline(vk::Extent2D viewportExtent, vk::Re
 
 	vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo{{}, dynamicStates};
 
-	std::vector<vk::VertexInputBindingDescription> vertexInputBindingDescriptions = {Vertex::getBindingDescription(), InstanceVertex::getBindingDescription()};
-	auto totalInputAttributeDescriptions = Vertex::getAttributeDescriptions();
-	auto instanceInputAttributeDescriptions = InstanceVertex::getAttributeDescriptions();
-	totalInputAttributeDescriptions.insert(totalInputAttributeDescriptions.end(), instanceInputAttributeDescriptions.begin(), instanceInputAttributeDescriptions.end());
-	vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{{}, vertexInputBindingDescriptions, totalInputAttributeDescriptions};
+	//both pipelines pull their vertices, quad corners come from gl_VertexIndex and instances from a storage buffer
+	vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
 
 	vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo{{}, vk::PrimitiveTopology::eTriangleStrip, VK_FALSE};
 
@@ -541,7 +573,7 @@ auto VulkanResources::createGraphicsPipeline(vk::Extent2D viewportExtent, vk::Re
 
 	vk::GraphicsPipelineCreateInfo pipelineCreateInfo{{}, shaderStages, &vertexInputStateCreateInfo, &inputAssemblyStateCreateInfo, nullptr,
 		&viewportStateCreateInfo, &rasterizationStateCreateInfo, &multisampleStateCreateInfo, &depthStencilCreateInfo, &colorBlendStateCreateInfo,
-		&dynamicStateCreateInfo, pipelineLayout.get(), renderPass, 0};
+		&dynamicStateCreateInfo, tileMapPipeline ? tileMapPipelineLayout.get() : pipelineLayout.get(), renderPass, 0};
 	auto pipeline = errorFatal(device->createGraphicsPipelineUnique(nullptr, pipelineCreateInfo), "couldn't create graphics pipeline"s);
 	return pipeline;
 }
@@ -645,12 +677,13 @@ auto VulkanResources::createUniformBuffers()
 
 auto VulkanResources::createDescriptorPool()
 {
-	vk::DescriptorPoolSize uniformPoolSize{vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT};
+	vk::DescriptorPoolSize uniformPoolSize{vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT * 2};
 	vk::DescriptorPoolSize samplerPoolSize{vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT};
+	vk::DescriptorPoolSize storagePoolSize{vk::DescriptorType::eStorageBuffer, MAX_FRAMES_IN_FLIGHT * 4};
 
-	std::vector poolSizes{uniformPoolSize, samplerPoolSize};
+	std::vector poolSizes{uniformPoolSize, samplerPoolSize, storagePoolSize};
 
-	vk::DescriptorPoolCreateInfo poolCreateInfo{{}, MAX_FRAMES_IN_FLIGHT, poolSizes};
+	vk::DescriptorPoolCreateInfo poolCreateInfo{{}, MAX_FRAMES_IN_FLIGHT * 2, poolSizes};
 	return errorFatal(device->createDescriptorPoolUnique(poolCreateInfo), "couldn't create descriptor pool"s);
 }
 
@@ -671,7 +704,19 @@ auto VulkanResources::createDescriptorSets()
 
 		vk::WriteDescriptorSet imageDescriptorWrite{descriptorSets[i], 1, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo};
 
-		std::vector descriptorWrites{bufferDescriptorWrite, imageDescriptorWrite};
+		vk::DescriptorBufferInfo transformGroupBufferInfo{transformGroupBuffers[i].get(), 0, VK_WHOLE_SIZE};
+
+		vk::WriteDescriptorSet transformGroupDescriptorWrite{descriptorSets[i], 2, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &transformGroupBufferInfo};
+
+		vk::DescriptorBufferInfo instanceBufferInfo{instanceBuffers[i].get(), 0, VK_WHOLE_SIZE};
+
+		vk::WriteDescriptorSet instanceDescriptorWrite{descriptorSets[i], 3, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &instanceBufferInfo};
+
+		vk::DescriptorBufferInfo glyphTableBufferInfo{glyphTableBuffer.get(), 0, VK_WHOLE_SIZE};
+
+		vk::WriteDescriptorSet glyphTableDescriptorWrite{descriptorSets[i], 4, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &glyphTableBufferInfo};
+
+		std::vector descriptorWrites{bufferDescriptorWrite, imageDescriptorWrite, transformGroupDescriptorWrite, instanceDescriptorWrite, glyphTableDescriptorWrite};
 
 		device->updateDescriptorSets(descriptorWrites, {});
 	}
@@ -679,6 +724,14 @@ auto VulkanResources::createDescriptorSets()
 	return descriptorSets;
 }
 
+auto VulkanResources::createTileMapDescriptorSets()
+{
+	std::vector<vk::DescriptorSetLayout> descriptorSetLayouts(MAX_FRAMES_IN_FLIGHT, tileMapDescriptorSetLayout.get());
+
+	vk::DescriptorSetAllocateInfo allocateInfo{descriptorPool.get(), descriptorSetLayouts};
+	return errorFatal(device->allocateDescriptorSets(allocateInfo), "couldn't allocate tile map descriptor sets"s);
+}
+
 template<class Data>
 auto VulkanResources::createStagingBuffer(Data* data, vk::DeviceSize size)
 {
@@ -712,13 +765,35 @@ auto VulkanResources::createHostVisibleBuffer(vk::DeviceSize size, vk::BufferUsa
 	return createBuffer(size, bufferUsage, vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible);
 }
 
-auto VulkanResources::createInstanceVertexBuffers()
+auto VulkanResources::createInstanceBuffers()
+{
+	std::vector<vk::UniqueBuffer> buffers(MAX_FRAMES_IN_FLIGHT);
+	std::vector<vk::UniqueDeviceMemory> buffersMemory(MAX_FRAMES_IN_FLIGHT);
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		std::tie(buffers[i], buffersMemory[i]) = createHostVisibleBuffer(sizeof(PackedInstance) * MAX_QUAD_INSTANCES, vk::BufferUsageFlagBits::eStorageBuffer);
+	}
+	return std::make_tuple(std::move(buffers), std::move(buffersMemory));
+}
+
+auto VulkanResources::createTransformGroupBuffers()
+{
+	std::vector<vk::UniqueBuffer> buffers(MAX_FRAMES_IN_FLIGHT);
+	std::vector<vk::UniqueDeviceMemory> buffersMemory(MAX_FRAMES_IN_FLIGHT);
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		std::tie(buffers[i], buffersMemory[i]) = createHostVisibleBuffer(sizeof(GroupTransform) * MAX_TRANSFORM_GROUPS, vk::BufferUsageFlagBits::eStorageBuffer);
+	}
+	return std::make_tuple(std::move(buffers), std::move(buffersMemory));
+}
+
+auto VulkanResources::createTileBuffers(vk::DeviceSize size)
 {
 	std::vector<vk::UniqueBuffer> buffers(MAX_FRAMES_IN_FLIGHT);
 	std::vector<vk::UniqueDeviceMemory> buffersMemory(MAX_FRAMES_IN_FLIGHT);
 	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
-		std::tie(buffers[i], buffersMemory[i]) = createHostVisibleBuffer(sizeof(InstanceVertex) * ObjectPools::quads.capacity(), vk::BufferUsageFlagBits::eVertexBuffer);
+		std::tie(buffers[i], buffersMemory[i]) = createHostVisibleBuffer(size, vk::BufferUsageFlagBits::eStorageBuffer);
 	}
 	return std::make_tuple(std::move(buffers), std::move(buffersMemory));
 }
@@ -822,30 +897,26 @@ auto VulkanResources::createImage(uint32_t width, uint32_t height, vk::Format fo
 
 auto VulkanResources::createTextureImage()
 {
-	int textureWidth{}, textureHeight{}, textureChannels{};
-	stbi_uc* pixels = stbi_load("textures/DejaVu mono.png", &textureWidth, &textureHeight,
-								&textureChannels, STBI_rgb_alpha);
-	vk::DeviceSize imageSize = textureWidth * textureHeight * 4;
-
-	errorFatal(pixels, "couldn't load texture image"s);
-
-	auto [stagingBuffer, stagingBufferMemory] = createStagingBuffer(pixels, imageSize);
+	uint32_t textureWidth = glyphCache->getWidth();
+	uint32_t textureHeight = glyphCache->getHeight();
+	vk::DeviceSize imageSize = vk::DeviceSize(textureWidth) * textureHeight * glyphCache->getBytesPerPixel();
 
-	stbi_image_free(pixels);
+	auto [stagingBuffer, stagingBufferMemory] = createStagingBuffer(glyphCache->getPixels(), imageSize);
+	glyphCache->clearDirtyRegions(glyphCache->getDirtyRegions().size());
 
-	auto [textureImage, textureImageMemory] = createImage((uint32_t)textureWidth, (uint32_t)textureHeight, vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal,
+	auto [textureImage, textureImageMemory] = createImage(textureWidth, textureHeight, textureImageFormat, vk::ImageTiling::eOptimal,
 														  vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-	transitionImageLayout(textureImage.get(), vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-	copyBufferToImage(stagingBuffer.get(), textureImage.get(), (uint32_t)textureWidth, (uint32_t)textureHeight);
-	transitionImageLayout(textureImage.get(), vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+	transitionImageLayout(textureImage.get(), textureImageFormat, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+	copyBufferToImage(stagingBuffer.get(), textureImage.get(), textureWidth, textureHeight);
+	transitionImageLayout(textureImage.get(), textureImageFormat, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
 
 	return std::make_tuple(std::move(textureImage), std::move(textureImageMemory));
 }
 
 auto VulkanResources::createTextureImageView()
 {
-	return createImageView(textureImage.get(), vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor);
+	return createImageView(textureImage.get(), textureImageFormat, vk::ImageAspectFlagBits::eColor);
 }
 
 auto VulkanResources::createTextureSampler()
@@ -859,6 +930,18 @@ auto VulkanResources::createTextureSampler()
 	return errorFatal(device->createSamplerUnique(samplerCreateInfo), "couldn't create texture sampler"s);
 }
 
+auto VulkanResources::createGlyphStagingBuffers()
+{
+	vk::DeviceSize bufferSize = vk::DeviceSize(glyphCache->getWidth()) * glyphCache->getHeight() * glyphCache->getBytesPerPixel();
+	std::vector<vk::UniqueBuffer> buffers(MAX_FRAMES_IN_FLIGHT);
+	std::vector<vk::UniqueDeviceMemory> buffersMemory(MAX_FRAMES_IN_FLIGHT);
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		std::tie(buffers[i], buffersMemory[i]) = createHostVisibleBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc);
+	}
+	return std::make_tuple(std::move(buffers), std::move(buffersMemory));
+}
+
 auto VulkanResources::createDepthResources(SwapchainResources const& swapchainResources)
 {
 	auto depthFormat = findDepthFormat();
@@ -888,18 +971,20 @@ auto VulkanResources::createCommandBuffers()
 	return errorFatal(device->allocateCommandBuffers(commandBufferAllocateInfo), "couldn't allocate command buffers"s);
 }
 
-auto VulkanResources::updateUniformBuffer(uint64_t frameIndex)
+static glm::mat4 getScreenProjection()
 {
-	static auto startTime = std::chrono::high_resolution_clock::now();
-	auto currentTime = std::chrono::high_resolution_clock::now();
+	return glm::ortho(-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 100.0f) * glm::lookAt(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+}
 
-	auto elapsedTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-	UniformBufferObject vp{glm::ortho(-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 100.0f)};
-	vp.vp *= glm::lookAt(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+auto VulkanResources::updateUniformBuffer(uint64_t frameIndex)
+{
+	UniformBufferObject vp{getScreenProjection()};
+	vp.cameraVp = camera ? vp.vp * camera->getViewMatrix() : vp.vp;
 
 	auto data = errorFatal(device->mapMemory(uniformBuffersMemory[frameIndex].get(), 0, sizeof(vp)), "couldn't map memory"s);
 	memcpy(data, &vp, sizeof(vp));
 	device->unmapMemory(uniformBuffersMemory[frameIndex].get());
+	frameStatistics.uploadedBytes += sizeof(vp);
 }
 
 auto VulkanResources::updateInstanceBuffer(uint64_t frameIndex)
@@ -909,15 +994,114 @@ auto VulkanResources::updateInstanceBuffer(uint64_t frameIndex)
 
 	auto elapsedTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-	if (ObjectPools::quads.size() > 0)
+	//the entities are packed straight into the mapped buffer
+	auto data = static_cast<PackedInstance*>(errorFatal(device->mapMemory(instanceBuffersMemory[frameIndex].get(),
+																		  0, sizeof(PackedInstance) * MAX_QUAD_INSTANCES), "couldn't map memory"s));
+
+	instanceCount = static_cast<uint32_t>(extractQuadInstances(GameWorld::entities, data, MAX_QUAD_INSTANCES, systemThreads));
+
+	device->unmapMemory(instanceBuffersMemory[frameIndex].get());
+	frameStatistics.uploadedBytes += sizeof(PackedInstance) * instanceCount;
+}
+
+//the group transforms are only resolved and uploaded into a frame's buffer when a group changed since that buffer was last written
+auto VulkanResources::updateTransformGroupBuffer(uint64_t frameIndex)
+{
+	auto const& transformGroups = GameWorld::transformGroups;
+	if (uploadedGroupVersions[frameIndex] == transformGroups.getVersion()) return;
+
+	auto data = static_cast<GroupTransform*>(errorFatal(device->mapMemory(transformGroupBuffersMemory[frameIndex].get(),
+																		  0, sizeof(GroupTransform) * MAX_TRANSFORM_GROUPS), "couldn't map memory"s));
+	transformGroups.resolve(data);
+	device->unmapMemory(transformGroupBuffersMemory[frameIndex].get());
+
+	uploadedGroupVersions[frameIndex] = transformGroups.getVersion();
+	frameStatistics.uploadedBytes += sizeof(GroupTransform) * transformGroups.getUsedCount();
+}
+
+auto VulkanResources::updateGlyphAtlas(uint64_t frameIndex)
+{
+	auto& uploads = glyphUploads[frameIndex];
+	uploads.clear();
+
+	auto const& dirtyRegions = glyphCache->getDirtyRegions();
+	if (dirtyRegions.empty()) return;
+
+	vk::DeviceSize pixelSize = glyphCache->getBytesPerPixel();
+	vk::DeviceSize stagingSize = vk::DeviceSize(glyphCache->getWidth()) * glyphCache->getHeight() * pixelSize;
+	auto data = static_cast<uint8_t*>(errorFatal(device->mapMemory(glyphStagingBuffersMemory[frameIndex].get(), 0, stagingSize), "couldn't map memory"s));
+
+	vk::DeviceSize offset = 0;
+	for (auto const& region : dirtyRegions)
 	{
-		auto data = static_cast<InstanceVertex*>(errorFatal(device->mapMemory(instanceVertexBufferMemory[frameIndex].get(),
-																			  0, sizeof(InstanceVertex) * ObjectPools::quads.size()), "couldn't map memory"s));
+		vk::DeviceSize regionSize = vk::DeviceSize(region.width) * region.height * pixelSize;
+		if (offset + regionSize > stagingSize) break;
 
-		memcpy(data, ObjectPools::quads.data(), sizeof(InstanceVertex) * ObjectPools::quads.size());
+		for (uint32_t row = 0; row < region.height; row++)
+		{
+			memcpy(data + offset + vk::DeviceSize(row) * region.width * pixelSize,
+				glyphCache->getPixels() + (vk::DeviceSize(region.y + row) * glyphCache->getWidth() + region.x) * pixelSize, vk::DeviceSize(region.width) * pixelSize);
+		}
 
-		device->unmapMemory(instanceVertexBufferMemory[frameIndex].get());
+		vk::ImageSubresourceLayers subresourceLayers{vk::ImageAspectFlagBits::eColor, 0, 0, 1};
+		uploads.push_back(vk::BufferImageCopy{offset, region.width, region.height, subresourceLayers,
+			{static_cast<int32_t>(region.x), static_cast<int32_t>(region.y), 0}, {region.width, region.height, 1}});
+		offset += regionSize;
 	}
+
+	device->unmapMemory(glyphStagingBuffersMemory[frameIndex].get());
+	glyphCache->clearDirtyRegions(uploads.size());
+	frameStatistics.uploadedBytes += offset;
+}
+
+auto VulkanResources::updateTileBuffer(uint64_t frameIndex)
+{
+	if (!tileMap) return;
+
+	//every frame's buffer has to catch up on the chunks changed since it was last written, chunks out of view wait until they scroll in
+	for (auto chunk : tileMap->getDirtyChunks())
+	{
+		for (auto& pendingChunks : tileChunksPending)
+		{
+			pendingChunks[chunk] = true;
+		}
+	}
+	tileMap->clearDirtyChunks();
+
+	auto& pendingChunks = tileChunksPending[frameIndex];
+	auto visibleChunks = tileMap->getVisibleChunks();
+	uint8_t* data = nullptr;
+	for (std::size_t y = visibleChunks.y; y < visibleChunks.w; y++)
+	{
+		for (std::size_t x = visibleChunks.x; x < visibleChunks.z; x++)
+		{
+			auto chunk = y * tileMap->getChunkCountX() + x;
+			if (!pendingChunks[chunk]) continue;
+
+			if (!data) data = static_cast<uint8_t*>(errorFatal(device->mapMemory(tileBuffersMemory[frameIndex].get(), 0, VK_WHOLE_SIZE), "couldn't map memory"s));
+			memcpy(data + chunk * TileMap::CHUNK_BYTES, tileMap->getTiles() + chunk * TileMap::CHUNK_BYTES, TileMap::CHUNK_BYTES);
+			pendingChunks[chunk] = false;
+			frameStatistics.uploadedBytes += TileMap::CHUNK_BYTES;
+		}
+	}
+	if (data) device->unmapMemory(tileBuffersMemory[frameIndex].get());
+}
+
+auto VulkanResources::recordGlyphAtlasUpload(vk::CommandBuffer commandBuffer)
+{
+	auto const& uploads = glyphUploads[currentFrame];
+	if (uploads.empty()) return;
+
+	vk::ImageSubresourceRange subresourceRange{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+	vk::ImageMemoryBarrier toTransferBarrier{vk::AccessFlagBits::eShaderRead, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eShaderReadOnlyOptimal,
+		vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, textureImage.get(), subresourceRange};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, toTransferBarrier);
+
+	commandBuffer.copyBufferToImage(glyphStagingBuffers[currentFrame].get(), textureImage.get(), vk::ImageLayout::eTransferDstOptimal, uploads);
+
+	vk::ImageMemoryBarrier toShaderBarrier{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eTransferDstOptimal,
+		vk::ImageLayout::eShaderReadOnlyOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, textureImage.get(), subresourceRange};
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, toShaderBarrier);
 }
 
 auto VulkanResources::recordCommandBuffer(uint32_t imageIndex, SwapchainResources const& swapchainResources)
@@ -927,20 +1111,20 @@ auto VulkanResources::recordCommandBuffer(uint32_t imageIndex, SwapchainResource
 
 	errorFatal(commandBuffer.begin(commandBufferBeginInfo) == vk::Result::eSuccess, "couldn't begin command buffer"s);
 
+	if (timestampQueryPool)
+	{
+		commandBuffer.resetQueryPool(timestampQueryPool.get(), static_cast<uint32_t>(currentFrame * 2), 2);
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, timestampQueryPool.get(), static_cast<uint32_t>(currentFrame * 2));
+	}
+
+	recordGlyphAtlasUpload(commandBuffer);
+
 	std::vector<vk::ClearValue> clearValues{vk::ClearColorValue{std::array{0.0f, 0.0f, 0.0f, 1.0f}}, vk::ClearDepthStencilValue{1.0f, 0}};
 	vk::RenderPassBeginInfo renderPassBeginInfo{swapchainResources.renderPass.get(), swapchainResources.swapchainFramebuffers[imageIndex].get(),
 												{{0, 0}, swapchainResources.swapchainExtent}, clearValues};
 
 	commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
 
-	commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, swapchainResources.graphicsPipelines.current());
-
-	commandBuffer.bindVertexBuffers(0, vertexBuffer.get(), 0ULL);
-
-	commandBuffer.bindVertexBuffers(1, instanceVertexBuffer[currentFrame].get(), 0ULL);
-
-	commandBuffer.bindIndexBuffer(indexBuffer.get(), 0, vk::IndexType::eUint16);
-
 	vk::Viewport viewport{0.0f, 0.0f, static_cast<float>(swapchainResources.swapchainExtent.width),
 		static_cast<float>(swapchainResources.swapchainExtent.height), 0.0f, 1.0f};
 	commandBuffer.setViewport(0, viewport);
@@ -948,12 +1132,56 @@ auto VulkanResources::recordCommandBuffer(uint32_t imageIndex, SwapchainResource
 	vk::Rect2D scissor{{0, 0}, swapchainResources.swapchainExtent};
 	commandBuffer.setScissor(0, scissor);
 
+	if (tileMap)
+	{
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, swapchainResources.tileMapPipeline.get());
+
+		std::array tileMapSets{descriptorSets[currentFrame], tileMapDescriptorSets[currentFrame]};
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, tileMapPipelineLayout.get(), 0, tileMapSets, {});
+
+		auto pushConstants = tileMap->getPushConstants();
+		commandBuffer.pushConstants(tileMapPipelineLayout.get(), vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0,
+			sizeof(pushConstants), &pushConstants);
+
+		//clip the board to the camera viewport so panning doesn't draw it over the ui
+		if (camera)
+		{
+			auto const& cameraViewport = camera->getViewport();
+			auto projection = getScreenProjection();
+			glm::vec2 extent{swapchainResources.swapchainExtent.width, swapchainResources.swapchainExtent.height};
+			auto toPixels = [&](glm::vec2 screenPoint)
+			{
+				auto clip = projection * glm::vec4(screenPoint, 0.0f, 1.0f);
+				return (glm::vec2(clip) / clip.w * 0.5f + 0.5f) * extent;
+			};
+			auto first = toPixels({cameraViewport.x, cameraViewport.y});
+			auto second = toPixels({cameraViewport.x + cameraViewport.z, cameraViewport.y + cameraViewport.w});
+			auto pixelBegin = glm::clamp(glm::min(first, second), glm::vec2(0.0f), extent);
+			auto pixelEnd = glm::clamp(glm::max(first, second), glm::vec2(0.0f), extent);
+			vk::Rect2D boardScissor{{static_cast<int32_t>(pixelBegin.x), static_cast<int32_t>(pixelBegin.y)},
+				{static_cast<uint32_t>(pixelEnd.x - pixelBegin.x), static_cast<uint32_t>(pixelEnd.y - pixelBegin.y)}};
+			commandBuffer.setScissor(0, boardScissor);
+		}
+
+		commandBuffer.draw(QUAD_VERTEX_COUNT, 1, 0, 0);
+
+		commandBuffer.setScissor(0, scissor);
+	}
+
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, swapchainResources.graphicsPipelines.current());
+
 	commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout.get(), 0, descriptorSets[currentFrame], {});
 
-	commandBuffer.drawIndexed(static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(ObjectPools::quads.size()), 0, 0, 0);
+	commandBuffer.draw(QUAD_VERTEX_COUNT, instanceCount, 0, 0);
 
 	commandBuffer.endRenderPass();
 
+	if (timestampQueryPool)
+	{
+		commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, timestampQueryPool.get(), static_cast<uint32_t>(currentFrame * 2 + 1));
+		timestampsWritten[currentFrame] = true;
+	}
+
 	errorFatal(commandBuffer.end() == vk::Result::eSuccess, "couldn't end command buffer"s);
 }
 
@@ -974,6 +1202,33 @@ auto VulkanResources::createSyncObjects()
 	return std::make_tuple(std::move(imageAvailableSemaphores), std::move(renderFinishedSemaphores), std::move(inFlightFences));
 }
 
+auto VulkanResources::createTimestampQueryPool()
+{
+	auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+	timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+	if (queueFamilies[queueFamilyIndices.graphicsFamily].timestampValidBits == 0 || timestampPeriod <= 0.0f)
+	{
+		return vk::UniqueQueryPool{};
+	}
+
+	vk::QueryPoolCreateInfo queryPoolCreateInfo{{}, vk::QueryType::eTimestamp, MAX_FRAMES_IN_FLIGHT * 2};
+	return errorFatal(device->createQueryPoolUnique(queryPoolCreateInfo), "couldn't create timestamp query pool"s);
+}
+
+void VulkanResources::readFrameTimestamps(uint64_t frameIndex)
+{
+	if (!timestampQueryPool || !timestampsWritten[frameIndex]) return;
+
+	std::array<uint64_t, 2> timestamps{};
+	auto result = device->getQueryPoolResults(timestampQueryPool.get(), static_cast<uint32_t>(frameIndex * 2), 2, sizeof(timestamps), timestamps.data(),
+		sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+	if (result == vk::Result::eSuccess)
+	{
+		frameStatistics.gpuTime = (timestamps[1] - timestamps[0]) * static_cast<double>(timestampPeriod) / 1000000000.0;
+		frameStatistics.gpuTimeAvailable = true;
+	}
+}
+
 SwapchainResources::SwapchainResources(VulkanResources& vulkan, RenderingPipelines::Type initialType, vk::SwapchainKHR oldSwapchain)
 {
 	std::tie(swapchain, swapchainImages, swapchainImageFormat, swapchainExtent) = vulkan.createSwapchain(vulkan.getSwapchainSupportDetails(vulkan.physicalDevice),
@@ -994,6 +1249,9 @@ SwapchainResources::SwapchainResources(VulkanResources& vulkan, RenderingPipelin
 
 	graphicsPipelines = RenderingPipelines(vulkan, swapchainExtent, renderPass.get(), initialType);
 	formatPrint(std::cout, "Created {} graphics pipelines\n"sv, graphicsPipelines.size());
+
+	tileMapPipeline = vulkan.createGraphicsPipeline(swapchainExtent, renderPass.get(), vk::PolygonMode::eFill, true);
+	formatPrint(std::cout, "Created tile map pipeline\n"sv);
 }
 
 template<class T>
@@ -1022,9 +1280,9 @@ RenderingPipelines::RenderingPipelines(VulkanResources& vulkan, vk::Extent2D vie
 	switchPipeline(initialType);
 }
 
-VulkanResources::VulkanResources(EventHandler* eventHandler)
+VulkanResources::VulkanResources(EventHandler* eventHandler, Font const& font)
 	:windowContext(),
-	renderWindow(800, 800, windowContext, eventHandler)
+	renderWindow(800, 800, windowContext, eventHandler), glyphCache(font.glyphCache)
 {
 	//load vulkan specific funcs into dispatcher
 	vk::DynamicLoader dynamicLoader;
@@ -1068,6 +1326,10 @@ VulkanResources::VulkanResources(EventHandler* eventHandler)
 	pipelineLayout = createGraphicsPipelineLayout();
 	formatPrint(std::cout, "Created graphics pipeline layout\n"sv);
 
+	tileMapDescriptorSetLayout = createTileMapDescriptorSetLayout();
+	tileMapPipelineLayout = createTileMapPipelineLayout();
+	formatPrint(std::cout, "Created tile map pipeline layout\n"sv);
+
 	shortBufferCommandPool = createCommandPool(vk::CommandPoolCreateFlagBits::eTransient);
 	formatPrint(std::cout, "Created short buffer command pool\n"sv);
 
@@ -1076,6 +1338,7 @@ VulkanResources::VulkanResources(EventHandler* eventHandler)
 	commandPool = createCommandPool(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
 	formatPrint(std::cout, "Created command pool\n"sv);
 
+	textureImageFormat = glyphCache->isDistanceField() ? vk::Format::eR8Unorm : vk::Format::eR8G8B8A8Srgb;
 	std::tie(textureImage, textureImageMemory) = createTextureImage();
 	formatPrint(std::cout, "Created texture image\n"sv);
 
@@ -1085,14 +1348,19 @@ VulkanResources::VulkanResources(EventHandler* eventHandler)
 	textureSampler = createTextureSampler();
 	formatPrint(std::cout, "Created texture sampler\n"sv);
 
-	std::tie(vertexBuffer, vertexBufferMemory) = createDeviceLocalBuffer(vertices, vk::BufferUsageFlagBits::eVertexBuffer);
-	formatPrint(std::cout, "Created vertex buffer\n"sv);
+	std::tie(glyphStagingBuffers, glyphStagingBuffersMemory) = createGlyphStagingBuffers();
+	glyphUploads.resize(MAX_FRAMES_IN_FLIGHT);
+	formatPrint(std::cout, "Created {} glyph staging buffers\n"sv, glyphStagingBuffers.size());
+
+	std::tie(instanceBuffers, instanceBuffersMemory) = createInstanceBuffers();
+	formatPrint(std::cout, "Created {} instance buffers\n"sv, instanceBuffers.size());
 
-	std::tie(instanceVertexBuffer, instanceVertexBufferMemory) = createInstanceVertexBuffers();
-	formatPrint(std::cout, "Created instance vertex buffer\n"sv);
+	std::tie(glyphTableBuffer, glyphTableBufferMemory) = createDeviceLocalBuffer(font.getGlyphTable(), vk::BufferUsageFlagBits::eStorageBuffer);
+	formatPrint(std::cout, "Created glyph table buffer\n"sv);
 
-	std::tie(indexBuffer, indexBufferMemory) = createDeviceLocalBuffer(indices, vk::BufferUsageFlagBits::eIndexBuffer);
-	formatPrint(std::cout, "Created index buffer\n"sv);
+	std::tie(transformGroupBuffers, transformGroupBuffersMemory) = createTransformGroupBuffers();
+	uploadedGroupVersions.fill(std::numeric_limits<uint64_t>::max());
+	formatPrint(std::cout, "Created {} transform group buffers\n"sv, transformGroupBuffers.size());
 
 	std::tie(uniformBuffers, uniformBuffersMemory) = createUniformBuffers();
 	formatPrint(std::cout, "Created {} uniform buffers\n"sv, uniformBuffers.size());
@@ -1103,11 +1371,17 @@ VulkanResources::VulkanResources(EventHandler* eventHandler)
 	descriptorSets = createDescriptorSets();
 	formatPrint(std::cout, "Created descriptor sets\n"sv);
 
+	tileMapDescriptorSets = createTileMapDescriptorSets();
+	formatPrint(std::cout, "Allocated tile map descriptor sets\n"sv);
+
 	commandBuffers = createCommandBuffers();
 	formatPrint(std::cout, "Allocated command buffer\n"sv);
 
 	std::tie(imageAvailableSemaphores, renderFinishedSemaphores, inFlightFences) = createSyncObjects();
 	formatPrint(std::cout, "Created synchronization resources\n"sv);
+
+	timestampQueryPool = createTimestampQueryPool();
+	formatPrint(std::cout, timestampQueryPool ? "Created timestamp query pool\n"sv : "GPU timestamps not supported\n"sv);
 }
 
 bool VulkanResources::windowCloseStatus()
@@ -1120,20 +1394,10 @@ void VulkanResources::setWindowShouldClose()
 	glfwSetWindowShouldClose(renderWindow, true);
 }
 
-std::pair<double, double> VulkanResources::getCursorCoordinates()
-{
-	double xPos, yPos;
-	int windowWidth, windowHeight;
-	glfwGetCursorPos(renderWindow, &xPos, &yPos);
-	glfwGetWindowSize(renderWindow, &windowWidth, &windowHeight);
-	xPos = xPos / windowWidth * 2.0 - 1.0;
-	yPos = yPos / windowHeight * 2.0 - 1.0;
-	return {xPos, yPos};
-}
-
 void VulkanResources::drawFrame()
 {
 	auto waitResult = device->waitForFences(inFlightFences[currentFrame].get(), VK_TRUE, std::numeric_limits<uint64_t>::max());
+	readFrameTimestamps(currentFrame);
 
 	oldSwapchainResources.updateCleanup();
 
@@ -1186,8 +1450,14 @@ void VulkanResources::recreateSwapchainResources()
 
 void VulkanResources::submitImage(SwapchainResources const& swapchainResources, uint32_t imageIndex, bool isSwapchainRetired)
 {
+	if (lateLatchCallback) lateLatchCallback();
+
+	frameStatistics.uploadedBytes = 0;
 	updateUniformBuffer(currentFrame);
 	updateInstanceBuffer(currentFrame);
+	updateTransformGroupBuffer(currentFrame);
+	updateGlyphAtlas(currentFrame);
+	updateTileBuffer(currentFrame);
 
 	commandBuffers[currentFrame].reset();
 
@@ -1200,6 +1470,7 @@ void VulkanResources::submitImage(SwapchainResources const& swapchainResources,
 
 	device->resetFences(inFlightFences[currentFrame].get());
 	errorFatal(graphicsQueue.submit(submitInfo, inFlightFences[currentFrame].get()), "couldn't submit to queue"s);
+	frameStatistics.submitTime = glfwGetTime();
 
 	vk::PresentInfoKHR presentInfo{signalSemaphores, swapchainResources.swapchain.get(), imageIndex};
 
@@ -1219,6 +1490,36 @@ void VulkanResources::submitImage(SwapchainResources const& swapchainResources,
 	}
 }
 
+//the palette is uploaded once here, cell changes are streamed every frame
+void VulkanResources::setTileMap(TileMap* newTileMap)
+{
+	errorFatal(device->waitIdle(), "couldn't wait for device idle"s);
+
+	tileMap = newTileMap;
+	if (!tileMap) return;
+
+	std::tie(tileBuffers, tileBuffersMemory) = createTileBuffers(tileMap->getTileBufferSize());
+	tileChunksPending.assign(MAX_FRAMES_IN_FLIGHT, std::vector<bool>(tileMap->getChunkCount(), true));
+	tileMap->clearDirtyChunks();
+
+	std::tie(tilePaletteBuffer, tilePaletteBufferMemory) = createDeviceLocalBuffer(tileMap->getPalette(), vk::BufferUsageFlagBits::eUniformBuffer);
+
+	for (uint64_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		vk::DescriptorBufferInfo tileBufferInfo{tileBuffers[i].get(), 0, VK_WHOLE_SIZE};
+		vk::DescriptorBufferInfo paletteBufferInfo{tilePaletteBuffer.get(), 0, VK_WHOLE_SIZE};
+
+		vk::WriteDescriptorSet tileDescriptorWrite{tileMapDescriptorSets[i], 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &tileBufferInfo};
+
+		vk::WriteDescriptorSet paletteDescriptorWrite{tileMapDescriptorSets[i], 1, 0, 1, vk::DescriptorType::eUniformBuffer, nullptr, &paletteBufferInfo};
+
+		std::vector descriptorWrites{tileDescriptorWrite, paletteDescriptorWrite};
+
+		device->updateDescriptorSets(descriptorWrites, {});
+	}
+	formatPrint(std::cout, "Created tile map buffers for {} chunks\n"sv, tileMap->getChunkCount());
+}
+
 void VulkanResources::toggleWireframeMode()
 {
 	if (supportedFeatures.fillModeNonSolid)
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <functional>
+
 #include "constants.h"
 #include "Window.h"
-#include "ObjectPool.h"
-#include "QuadComponent.h"
 
 class VulkanResources;
 class EventHandler;
+class Font;
+class GlyphCache;
+class TileMap;
+class Camera;
+class ThreadPool;
 
 struct QueueFamilyIndices
 {
@@ -55,6 +60,15 @@ struct SwapchainResources
 	std::vector<vk::UniqueImageView> depthImageViews;
 	std::vector<vk::UniqueFramebuffer> swapchainFramebuffers;
 	RenderingPipelines graphicsPipelines;
+	vk::UniquePipeline tileMapPipeline;
+};
+
+struct FrameStatistics
+{
+	uint64_t uploadedBytes;
+	double gpuTime;
+	bool gpuTimeAvailable;
+	double submitTime;
 };
 
 template<class T>
@@ -78,16 +92,20 @@ private:
 class VulkanResources
 {
 public:
-	explicit VulkanResources(EventHandler* game);
+	VulkanResources(EventHandler* game, Font const& font);
 
 	bool windowCloseStatus();
 	void setWindowShouldClose();
 
-	std::pair<double, double> getCursorCoordinates();
+	void setLateLatchCallback(std::function<void()> const& callback) { lateLatchCallback = callback; }
+	void setTileMap(TileMap* newTileMap);
+	void setCamera(Camera const* newCamera) { camera = newCamera; }
+	void setSystemThreads(ThreadPool* newSystemThreads) { systemThreads = newSystemThreads; }
 
 	void drawFrame();
 	void stopRendering();
 	void toggleWireframeMode();
+	FrameStatistics const& getFrameStatistics() const { return frameStatistics; }
 
 	bool framebufferResized = false;
 
@@ -105,28 +123,51 @@ private:
 	vk::Queue presentationQueue;
 	vk::UniqueDescriptorSetLayout descriptorSetLayout;
 	vk::UniquePipelineLayout pipelineLayout;
+	vk::UniqueDescriptorSetLayout tileMapDescriptorSetLayout;
+	vk::UniquePipelineLayout tileMapPipelineLayout;
 	vk::UniqueCommandPool shortBufferCommandPool;
 	std::unique_ptr<SwapchainResources> swapchainResources;
 	OldResourceQueue<SwapchainResources> oldSwapchainResources;
 	vk::UniqueCommandPool commandPool;
+	std::shared_ptr<GlyphCache> glyphCache;
+	vk::Format textureImageFormat;
 	vk::UniqueImage textureImage;
 	vk::UniqueDeviceMemory textureImageMemory;
 	vk::UniqueImageView textureImageView;
 	vk::UniqueSampler textureSampler;
-	vk::UniqueBuffer vertexBuffer;
-	vk::UniqueDeviceMemory vertexBufferMemory;
-	std::vector<vk::UniqueBuffer> instanceVertexBuffer;
-	std::vector<vk::UniqueDeviceMemory> instanceVertexBufferMemory;
-	vk::UniqueBuffer indexBuffer;
-	vk::UniqueDeviceMemory indexBufferMemory;
+	std::vector<vk::UniqueBuffer> glyphStagingBuffers;
+	std::vector<vk::UniqueDeviceMemory> glyphStagingBuffersMemory;
+	std::vector<std::vector<vk::BufferImageCopy>> glyphUploads;
+	std::vector<vk::UniqueBuffer> instanceBuffers;
+	std::vector<vk::UniqueDeviceMemory> instanceBuffersMemory;
+	vk::UniqueBuffer glyphTableBuffer;
+	vk::UniqueDeviceMemory glyphTableBufferMemory;
+	std::vector<vk::UniqueBuffer> transformGroupBuffers;
+	std::vector<vk::UniqueDeviceMemory> transformGroupBuffersMemory;
+	std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> uploadedGroupVersions{};
 	std::vector<vk::UniqueBuffer> uniformBuffers;
 	std::vector<vk::UniqueDeviceMemory> uniformBuffersMemory;
 	vk::UniqueDescriptorPool descriptorPool;
 	std::vector<vk::DescriptorSet> descriptorSets;
+	TileMap* tileMap{};
+	std::vector<vk::UniqueBuffer> tileBuffers;
+	std::vector<vk::UniqueDeviceMemory> tileBuffersMemory;
+	std::vector<std::vector<bool>> tileChunksPending;
+	Camera const* camera{};
+	ThreadPool* systemThreads{};
+	uint32_t instanceCount{};
+	vk::UniqueBuffer tilePaletteBuffer;
+	vk::UniqueDeviceMemory tilePaletteBufferMemory;
+	std::vector<vk::DescriptorSet> tileMapDescriptorSets;
 	std::vector<vk::CommandBuffer> commandBuffers;
 	std::vector<vk::UniqueSemaphore> imageAvailableSemaphores;
 	std::vector<vk::UniqueSemaphore> renderFinishedSemaphores;
 	std::vector<vk::UniqueFence> inFlightFences;
+	vk::UniqueQueryPool timestampQueryPool;
+	float timestampPeriod{};
+	std::array<bool, MAX_FRAMES_IN_FLIGHT> timestampsWritten{};
+	FrameStatistics frameStatistics{};
+	std::function<void()> lateLatchCallback;
 	uint64_t currentFrame{0};
 
 	auto createDebugUtilsMessenger(vk::DebugUtilsMessengerCreateInfoEXT const& debugUtilsMessengerCreateInfo);
@@ -147,7 +188,9 @@ private:
 	auto createShaderModule(std::vector<char> const& shaderCode);
 	auto createDescriptorSetLayout();
 	auto createGraphicsPipelineLayout();
-	auto createGraphicsPipeline(vk::Extent2D viewportExtent, vk::RenderPass renderPass, vk::PolygonMode polygonMode);
+	auto createTileMapDescriptorSetLayout();
+	auto createTileMapPipelineLayout();
+	auto createGraphicsPipeline(vk::Extent2D viewportExtent, vk::RenderPass renderPass, vk::PolygonMode polygonMode, bool tileMapPipeline = false);
 	auto createCommandPool(vk::CommandPoolCreateFlags flags);
 	auto beginSingleTimeCommands();
 	auto endSingleTimeCommands(vk::CommandBuffer commandBuffer);
@@ -156,13 +199,16 @@ private:
 	auto createUniformBuffers();
 	auto createDescriptorPool();
 	auto createDescriptorSets();
+	auto createTileMapDescriptorSets();
+	auto createTileBuffers(vk::DeviceSize size);
 
 	template<class Data>
 	auto createStagingBuffer(Data* data, vk::DeviceSize size);
 	template<class Data>
 	auto createDeviceLocalBuffer(Data const& data, vk::BufferUsageFlags bufferUsage);
 	auto createHostVisibleBuffer(vk::DeviceSize size, vk::BufferUsageFlags bufferUsage);
-	auto createInstanceVertexBuffers();
+	auto createInstanceBuffers();
+	auto createTransformGroupBuffers();
 
 	auto copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
 	auto transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout);
@@ -170,11 +216,18 @@ private:
 	auto createTextureImage();
 	auto createTextureImageView();
 	auto createTextureSampler();
+	auto createGlyphStagingBuffers();
 	auto createCommandBuffers();
 	auto updateUniformBuffer(uint64_t frameIndex);
 	auto updateInstanceBuffer(uint64_t frameIndex);
+	auto updateTransformGroupBuffer(uint64_t frameIndex);
+	auto updateGlyphAtlas(uint64_t frameIndex);
+	auto updateTileBuffer(uint64_t frameIndex);
+	auto recordGlyphAtlasUpload(vk::CommandBuffer commandBuffer);
 	auto recordCommandBuffer(uint32_t imageIndex, SwapchainResources const& swapchainResources);
 	auto createSyncObjects();
+	auto createTimestampQueryPool();
+	void readFrameTimestamps(uint64_t frameIndex);
 	void submitImage(SwapchainResources const& swapchain, uint32_t imageIndex, bool isSwapchainRetired = false);
 	void recreateSwapchainResources();
 
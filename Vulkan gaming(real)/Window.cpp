@@ -25,6 +25,11 @@ Window::Window(int32_t width, int32_t height, WindowContext const&, EventHandler
 	glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
 	glfwSetKeyCallback(window, keyCallback);
 	glfwSetMouseButtonCallback(window, mouseButtonCallback);
+	glfwSetCursorPosCallback(window, cursorPositionCallback);
+	glfwSetWindowSizeCallback(window, windowSizeCallback);
+	glfwSetScrollCallback(window, scrollCallback);
+
+	windowSizeCallback(window, width, height);
 }
 
 Window::~Window()
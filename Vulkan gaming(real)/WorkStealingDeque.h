@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+//Chase-Lev deque with a fixed power of two capacity, the owning thread pushes and pops at the bottom while any thread may steal from the top
+//T has to be trivially copyable, pop and steal return a default constructed T when there was nothing to take, push fails when the deque is full
+template<class T, std::size_t Capacity>
+class WorkStealingDeque
+{
+	static_assert(std::has_single_bit(Capacity), "work stealing deque capacity must be a power of two");
+
+public:
+	bool push(T element)
+	{
+		auto bottomIndex = bottom.load(std::memory_order_relaxed);
+		auto topIndex = top.load(std::memory_order_acquire);
+		if (bottomIndex - topIndex >= static_cast<int64_t>(Capacity)) return false;
+
+		elements[bottomIndex & (Capacity - 1)].store(element, std::memory_order_relaxed);
+		bottom.store(bottomIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	T pop()
+	{
+		auto bottomIndex = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(bottomIndex, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto topIndex = top.load(std::memory_order_relaxed);
+		if (topIndex > bottomIndex)
+		{
+			bottom.store(bottomIndex + 1, std::memory_order_relaxed);
+			return T{};
+		}
+
+		auto element = elements[bottomIndex & (Capacity - 1)].load(std::memory_order_relaxed);
+		if (topIndex == bottomIndex)
+		{
+			//last element, race the thieves for it
+			if (!top.compare_exchange_strong(topIndex, topIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) element = T{};
+			bottom.store(bottomIndex + 1, std::memory_order_relaxed);
+		}
+		return element;
+	}
+
+	T steal()
+	{
+		auto topIndex = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto bottomIndex = bottom.load(std::memory_order_acquire);
+		if (topIndex >= bottomIndex) return T{};
+
+		auto element = elements[topIndex & (Capacity - 1)].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(topIndex, topIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return T{};
+		return element;
+	}
+
+	bool empty() const { return top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed); }
+
+private:
+	alignas(64) std::atomic<int64_t> top{};
+	alignas(64) std::atomic<int64_t> bottom{};
+	std::array<std::atomic<T>, Capacity> elements{};
+};
\ No newline at end of file
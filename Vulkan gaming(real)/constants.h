@@ -11,6 +11,8 @@
 
 #include <array>
 
+#include "gameConstants.h"
+
 using namespace std::literals;
 
 static constexpr std::array<char const*, 1> VALIDATION_LAYERS{"VK_LAYER_KHRONOS_validation"};
@@ -19,64 +21,65 @@ static constexpr std::array<char const*, 1> OPTIONAL_DEVICE_FEATURES{ };
 
 static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 static constexpr double TIME_STEP = 0.0078125;
+static constexpr uint32_t GLYPH_PAGE_ROWS = 4;
+static constexpr uint64_t GLYPH_CACHE_MEMORY_BUDGET = 2 * 1024 * 1024;
+static constexpr bool USE_DISTANCE_FIELD_FONT = false;
+static constexpr std::size_t PERFORMANCE_OVERLAY_SAMPLES = 64;
+static constexpr double PERFORMANCE_OVERLAY_LABEL_INTERVAL = 0.25;
+static constexpr std::size_t INPUT_EVENT_QUEUE_SIZE = 256;
+static constexpr bool LATE_LATCH_INPUT = true;
+static constexpr uint64_t REPLAY_FAST_TICKS_PER_FRAME = 256;
+static constexpr std::size_t EVENT_CHANNEL_CAPACITY = 64;
+static constexpr bool USE_TILE_MAP_RENDERER = true;
+static constexpr float CAMERA_MAX_VISIBLE_CELLS = 2048.0f;
+static constexpr float CAMERA_MIN_VISIBLE_CELLS = 4.0f;
+static constexpr float CAMERA_PAN_SPEED = 1.5f;
+static constexpr float CAMERA_ZOOM_STEP = 1.25f;
+static constexpr uint64_t SOLVER_AUTOPLAY_INTERVAL = 8;
+static constexpr char const* SNAPSHOT_FILE = "savegame.bin";
+static constexpr std::size_t MAX_COMPONENT_TYPES = 32;
+static constexpr std::size_t ENTITY_SYSTEM_BATCH_SIZE = 4096;
+static constexpr std::size_t MAX_QUAD_INSTANCES = 2048;
+static constexpr std::size_t MAX_TRANSFORM_GROUPS = 1024;
+static constexpr std::size_t HIT_GRID_SIZE = 32;
+static constexpr float INSTANCE_COORDINATE_RANGE = 8.0f;
+static constexpr uint32_t QUAD_VERTEX_COUNT = 4;
 
-struct Vertex
-{
-	glm::vec3 position;
-	glm::vec2 texCoord;
-
-	static auto getBindingDescription()
-	{
-		vk::VertexInputBindingDescription bindingDescription{0, sizeof(Vertex), vk::VertexInputRate::eVertex};
-		return bindingDescription;
-	}
-	static auto getAttributeDescriptions()
-	{
-		std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{
-			{0, 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position)},
-			{1, 0, vk::Format::eR32G32Sfloat, offsetof(Vertex, texCoord)}
-		};
-		return attributeDescriptions;
-	}
-};
-
-struct InstanceVertex
+//std430 element of the instance storage buffer, the vertex shader reads it by gl_InstanceIndex and makes the quad corners from gl_VertexIndex
+//color is unorm8 rgba, position is snorm16 and scale unorm16 scaled by INSTANCE_COORDINATE_RANGE
+//glyphGroup holds the glyph table index in the low 16 bits and the transform group in the high 16 bits
+struct PackedInstance
 {
-	glm::vec4 color;
-	glm::vec3 position;
-	glm::vec2 scale;
-	glm::vec4 texOffsetScale;
-
-	static auto getBindingDescription()
-	{
-		vk::VertexInputBindingDescription bindingDescription{1, sizeof(InstanceVertex), vk::VertexInputRate::eInstance};
-		return bindingDescription;
-	}
-	static auto getAttributeDescriptions()
-	{
-		std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{
-			{2, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceVertex, color)},
-			{3, 1, vk::Format::eR32G32B32Sfloat, offsetof(InstanceVertex, position)},
-			{4, 1, vk::Format::eR32G32Sfloat, offsetof(InstanceVertex, scale)},
-			{5, 1, vk::Format::eR32G32B32A32Sfloat, offsetof(InstanceVertex, texOffsetScale)}
-		};
-		return attributeDescriptions;
-	}
+	uint32_t color;
+	uint32_t position;
+	uint32_t scale;
+	float depth;
+	uint32_t glyphGroup;
 };
 
 struct UniformBufferObject
 {
 	glm::mat4 vp;
+	glm::mat4 cameraVp;
 };
-
-static constexpr std::array<Vertex, 4> vertices = {
-	Vertex{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
-	Vertex{{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
-	Vertex{{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
-	Vertex{{1.0f, 1.0f, 0.0f}, {1.0f, 1.0f}}
+//std430 element of the transform group storage buffer, instance positions are scaled by scale.xy and moved by offset.xyz
+struct GroupTransform
+{
+	glm::vec4 offset;
+	glm::vec4 scale;
 };
 
-static constexpr std::array<uint16_t, 4> indices = {0, 1, 2, 3};
+struct TileMapPushConstants
+{
+	glm::vec4 boardRect;
+	glm::vec2 cellScale;
+	glm::vec2 glyphScale;
+	glm::uvec2 gridSize;
+	uint32_t atlasColumns;
+	uint32_t startChar;
+	uint32_t chunkCountX;
+	float depth;
+};
 
 #ifdef NDEBUG
 static constexpr bool ENABLE_VALIDATION_LAYERS = false;
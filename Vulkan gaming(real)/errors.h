@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+using namespace std::literals;
+
+inline std::ofstream debugLog{"log.txt", std::ios::binary};
+inline std::ofstream errorLog("errorLog.txt", std::ios::binary);
+
+inline auto errorFatal(bool val, std::string const& message = {})
+{
+	if (!val)
+	{
+		errorLog << message << "\n"s;
+		std::exit(-1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std::literals;
+
+//board and solver constants, kept free of Vulkan and GLFW so the headless tools can build without the SDK
+static constexpr uint32_t BOARD_CHUNK_SIZE = 64;
+static constexpr double INFINITE_MINE_DENSITY = 0.18;
+static constexpr uint64_t INFINITE_CHUNK_MEMORY_BUDGET = 4 * 1024 * 1024;
+static constexpr char const* INFINITE_CHUNK_STORE_FILE = "infinite_chunks.bin";
+static constexpr uint64_t SOLVER_MAX_SEARCH_NODES = 1 << 22;
+static constexpr std::size_t SOLVER_CACHE_CAPACITY = 4096;
+static constexpr uint64_t NO_GUESS_MAX_TRIALS = 1 << 16;
+static constexpr std::size_t JOURNAL_HISTORY_DEPTH = 256;
+static constexpr std::size_t WORK_STEALING_DEQUE_CAPACITY = 4096;
\ No newline at end of file
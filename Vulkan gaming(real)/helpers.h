@@ -1,11 +1,18 @@
 #pragma once
 
-#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <span>
+#include <vector>
 #include <fstream>
 #include <utility>
 
-#include "logging.h"
+#include "errors.h"
+#include "Random.h"
 
 template<class Vec, class Func>
 inline bool checkVectorContainsString(Vec vector, Func vecStrAccess, char const* str)
@@ -48,10 +55,55 @@ inline uint32_t xorshift32c(uint32_t state)
 	return state;
 }
 
-inline uint32_t randInt()
+inline char32_t decodeUtf8(std::string_view text, std::size_t& index)
 {
-	static uint32_t result{47};
-	return xorshift32(result);
+	static constexpr char32_t replacementChar = 0xFFFD;
+	unsigned char lead = text[index++];
+	if (lead < 0x80) return lead;
+
+	std::size_t length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+	if (length == 0 || lead >= 0xF8) return replacementChar;
+
+	char32_t codepoint = lead & (0x3F >> length);
+	for (std::size_t i = 0; i < length; i++)
+	{
+		if (index >= text.size() || (static_cast<unsigned char>(text[index]) & 0xC0) != 0x80) return replacementChar;
+		codepoint = (codepoint << 6) | (static_cast<unsigned char>(text[index++]) & 0x3F);
+	}
+	return codepoint;
+}
+
+inline void writeVarint(std::vector<uint8_t>& output, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		output.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	output.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool readVarint(std::span<uint8_t const> input, std::size_t& index, uint64_t& value)
+{
+	value = 0;
+	for (uint32_t shift = 0; shift < 64 && index < input.size(); shift += 7)
+	{
+		uint8_t byte = input[index++];
+		value |= uint64_t(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+	return false;
+}
+
+//maps small negative values to small unsigned ones, so they stay short as varints
+inline uint64_t encodeZigzag(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t decodeZigzag(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
 }
 
 template<class First, class Second>
@@ -6,11 +6,9 @@
 #include <string>
 
 #include "constants.h"
+#include "errors.h"
 #include "print.h"
 
-inline std::ofstream debugLog{"log.txt", std::ios::binary};
-inline std::ofstream errorLog("errorLog.txt", std::ios::binary);
-
 template<class T>
 inline auto errorFatal(vk::ResultValue<T>&& rv, std::string const& message = {})
 {
@@ -33,14 +31,6 @@ inline auto errorFatal(VkResult r, std::string const& message = {})
 {
 	errorFatal(vk::Result(r), message);
 }
-inline auto errorFatal(bool val, std::string const& message = {})
-{
-	if (!val)
-	{
-		errorLog << message << "\n"s;
-		std::exit(-1);
-	}
-}
 
 inline VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
 	VkDebugUtilsMessageTypeFlagsEXT messageType, VkDebugUtilsMessengerCallbackDataEXT const* callbackData, void*)
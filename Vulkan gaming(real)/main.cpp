@@ -8,7 +8,25 @@
 
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
-int main()
+static GameOptions parseOptions(int argc, char** argv)
+{
+	GameOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view argument{argv[i]};
+		if (argument == "--record"sv && i + 1 < argc) options.recordFilename = argv[++i];
+		else if (argument == "--replay"sv && i + 1 < argc) options.replayFilename = argv[++i];
+		else if (argument == "--headless"sv) options.headless = true;
+		else if (argument == "--fast"sv) options.fastReplay = true;
+		else if (argument == "--infinite"sv) options.infinite = true;
+		else if (argument == "--no-guess"sv) options.noGuess = true;
+		else if (argument == "--autosave"sv) options.autosave = true;
+		else formatPrint(std::cout, "Ignoring unknown argument {}\n"sv, argument);
+	}
+	return options;
+}
+
+int main(int argc, char** argv)
 {
 	if (!debugLog || !errorLog)
 	{
@@ -22,7 +40,7 @@ int main()
 
 	try
 	{
-		Game game{};
+		Game game{parseOptions(argc, argv)};
 	}
 	catch (std::exception const& e)
 	{
@@ -1,5 +1,7 @@
 #version 450
 
+layout(constant_id = 0) const bool DISTANCE_FIELD = false;
+
 layout(binding = 1) uniform sampler2D texSampler;
 
 layout(location = 0) in vec4 fragColor;
@@ -10,7 +12,18 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
-	vec4 texColor = texture(texSampler, fragTexOffsetScale.xy + fragTexCoord * fragTexOffsetScale.zw) * fragColor;
+	vec2 texCoord = fragTexOffsetScale.xy + fragTexCoord * fragTexOffsetScale.zw;
+	vec4 texColor;
+	if (DISTANCE_FIELD)
+	{
+		float distance = texture(texSampler, texCoord).r;
+		float edgeWidth = max(fwidth(distance), 0.0001);
+		texColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, distance)) * fragColor;
+	}
+	else
+	{
+		texColor = texture(texSampler, texCoord) * fragColor;
+	}
 	if (texColor.w < 0.01) discard;
 	outColor = texColor;
 }
\ No newline at end of file
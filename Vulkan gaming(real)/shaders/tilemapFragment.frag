@@ -0,0 +1,62 @@
+#version 450
+
+layout(constant_id = 0) const bool DISTANCE_FIELD = false;
+
+//matches BOARD_CHUNK_SIZE, tiles are stored chunk by chunk
+const uint CHUNK_SIZE = 64;
+
+layout(set = 0, binding = 1) uniform sampler2D texSampler;
+
+layout(set = 1, binding = 0) readonly buffer TileBuffer
+{
+	uint tiles[];
+} tileBuffer;
+
+layout(set = 1, binding = 1) uniform TilePalette
+{
+	vec4 colors[256];
+} palette;
+
+layout(push_constant) uniform TileMapPushConstants
+{
+	vec4 boardRect;
+	vec2 cellScale;
+	vec2 glyphScale;
+	uvec2 gridSize;
+	uint atlasColumns;
+	uint startChar;
+	uint chunkCountX;
+	float depth;
+} tileMap;
+
+layout(location = 0) in vec2 fragBoardCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	uvec2 cell = min(uvec2(fragBoardCoord), tileMap.gridSize - 1);
+	uvec2 chunk = cell / CHUNK_SIZE;
+	uvec2 chunkCell = cell % CHUNK_SIZE;
+	uint tileIndex = (chunk.y * tileMap.chunkCountX + chunk.x) * CHUNK_SIZE * CHUNK_SIZE + chunkCell.y * CHUNK_SIZE + chunkCell.x;
+	uint glyph = (tileBuffer.tiles[tileIndex >> 2] >> ((tileIndex & 3) * 8)) & 0xFF;
+	uint atlasCell = max(glyph, tileMap.startChar) - tileMap.startChar;
+
+	vec2 glyphOffset = vec2(atlasCell % tileMap.atlasColumns, atlasCell / tileMap.atlasColumns) * tileMap.cellScale;
+	vec2 texCoord = glyphOffset + fract(fragBoardCoord) * tileMap.glyphScale;
+	vec4 color = palette.colors[glyph];
+
+	vec4 texColor;
+	if (DISTANCE_FIELD)
+	{
+		float distance = textureGrad(texSampler, texCoord, dFdx(fragBoardCoord) * tileMap.glyphScale, dFdy(fragBoardCoord) * tileMap.glyphScale).r;
+		float edgeWidth = max(fwidth(distance), 0.0001);
+		texColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, distance)) * color;
+	}
+	else
+	{
+		texColor = textureGrad(texSampler, texCoord, dFdx(fragBoardCoord) * tileMap.glyphScale, dFdy(fragBoardCoord) * tileMap.glyphScale) * color;
+	}
+	if (texColor.w < 0.01) discard;
+	outColor = texColor;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject
+{
+	mat4 vp;
+	mat4 cameraVp;
+} ubo;
+
+layout(push_constant) uniform TileMapPushConstants
+{
+	vec4 boardRect;
+	vec2 cellScale;
+	vec2 glyphScale;
+	uvec2 gridSize;
+	uint atlasColumns;
+	uint startChar;
+	uint chunkCountX;
+	float depth;
+} tileMap;
+
+layout(location = 0) out vec2 fragBoardCoord;
+
+void main()
+{
+	//triangle strip corners in the order (0, 0), (1, 0), (0, 1), (1, 1)
+	vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+	fragBoardCoord = tileMap.boardRect.xy + corner * tileMap.boardRect.zw;
+	gl_Position = ubo.cameraVp * vec4(fragBoardCoord, tileMap.depth, 1.0);
+}
\ No newline at end of file
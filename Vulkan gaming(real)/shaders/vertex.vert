@@ -1,16 +1,42 @@
 #version 450
 
+//matches INSTANCE_COORDINATE_RANGE
+const float COORDINATE_RANGE = 8.0;
+
 layout(binding = 0) uniform UniformBufferObject
 {
 	mat4 vp;
 } ubo;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec2 inTexCoord;
-layout(location = 2) in vec4 inColor;
-layout(location = 3) in vec3 inTranslation;
-layout(location = 4) in vec2 inScale;
-layout(location = 5) in vec4 inTexOffsetScale;
+struct GroupTransform
+{
+	vec4 offset;
+	vec4 scale;
+};
+
+layout(std430, binding = 2) readonly buffer TransformGroups
+{
+	GroupTransform groups[];
+} transformGroups;
+
+struct PackedInstance
+{
+	uint color;
+	uint position;
+	uint scale;
+	float depth;
+	uint glyphGroup;
+};
+
+layout(std430, binding = 3) readonly buffer Instances
+{
+	PackedInstance instances[];
+} instanceBuffer;
+
+layout(std430, binding = 4) readonly buffer GlyphTable
+{
+	vec4 texOffsetScales[];
+} glyphTable;
 
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
@@ -18,8 +44,16 @@ layout(location = 2) out vec4 fragTexOffsetScale;
 
 void main()
 {
-	gl_Position = ubo.vp * vec4(vec3(inPosition.x * inScale.x, inPosition.y * inScale.y, inPosition.z) + inTranslation, 1.0);
-	fragColor = inColor;
-	fragTexCoord = inTexCoord;
-	fragTexOffsetScale = inTexOffsetScale;
+	PackedInstance instance = instanceBuffer.instances[gl_InstanceIndex];
+	//triangle strip corners in the order (0, 0), (1, 0), (0, 1), (1, 1)
+	vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+
+	vec2 translation = unpackSnorm2x16(instance.position) * COORDINATE_RANGE;
+	vec2 scale = unpackUnorm2x16(instance.scale) * COORDINATE_RANGE;
+	vec3 localPosition = vec3(corner * scale + translation, instance.depth);
+	GroupTransform group = transformGroups.groups[instance.glyphGroup >> 16];
+	gl_Position = ubo.vp * vec4(vec3(localPosition.xy * group.scale.xy, localPosition.z) + group.offset.xyz, 1.0);
+	fragColor = unpackUnorm4x8(instance.color);
+	fragTexCoord = corner;
+	fragTexOffsetScale = glyphTable.texOffsetScales[instance.glyphGroup & 0xFFFF];
 }
\ No newline at end of file
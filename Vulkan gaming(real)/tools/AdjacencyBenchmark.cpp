@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "AdjacencyKernel.h"
+#include "Random.h"
+
+//compares every adjacency kernel the CPU supports against the scalar one on a random mine grid,
+//the scalar kernel is built without auto vectorisation so the ratios hold at any optimisation level
+//usage: AdjacencyBenchmark [width] [height] [density] [repetitions]
+int main(int argc, char** argv)
+{
+	std::size_t width = argc > 1 ? std::stoul(argv[1]) : 4096;
+	std::size_t height = argc > 2 ? std::stoul(argv[2]) : 4096;
+	double density = argc > 3 ? std::stod(argv[3]) : 0.2;
+	std::size_t repetitions = argc > 4 ? std::stoul(argv[4]) : 20;
+
+	std::vector<uint8_t> mines(width * height);
+	Random random(1);
+	//same threshold test as the infinite board's mine hash
+	uint64_t mineThreshold = density >= 1.0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(std::ldexp(std::max(density, 0.0), 64));
+	for (auto& mine : mines) mine = random() < mineThreshold;
+
+	std::vector<AdjacencyKernel> kernels{ AdjacencyKernel::eScalar };
+	if (getBestAdjacencyKernel() != AdjacencyKernel::eScalar) kernels.push_back(AdjacencyKernel::eSse2);
+	if (getBestAdjacencyKernel() == AdjacencyKernel::eAvx2) kernels.push_back(AdjacencyKernel::eAvx2);
+
+	std::cout << width << "x" << height << " cells, mine density " << density << ", best of " << repetitions << " runs\n";
+	std::vector<uint8_t> reference(mines.size()), counts(mines.size());
+	double scalarTime = 0.0;
+	for (auto kernel : kernels)
+	{
+		double bestTime = INFINITY;
+		for (std::size_t i = 0; i < repetitions; i++)
+		{
+			auto startTime = std::chrono::steady_clock::now();
+			countAdjacentMines(mines.data(), width, height, counts.data(), kernel);
+			bestTime = std::min(bestTime, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+		}
+		if (kernel == AdjacencyKernel::eScalar)
+		{
+			reference = counts;
+			scalarTime = bestTime;
+		}
+
+		std::cout << getAdjacencyKernelName(kernel) << ": " << bestTime << " ms, " << width * height / bestTime / 1e6 << " Gcells/s, "
+			<< scalarTime / bestTime << "x scalar" << (counts == reference ? "" : ", MISMATCH") << "\n";
+	}
+	return 0;
+}
\ No newline at end of file
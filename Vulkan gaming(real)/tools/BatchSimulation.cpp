@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Board.h"
+#include "BoardAnalysis.h"
+#include "BoardGenerator.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+#include "helpers.h"
+
+//makes one move on a board that is still being played, every worker thread owns its own strategy
+class PlayStrategy
+{
+public:
+	virtual ~PlayStrategy() = default;
+	//random is the game's own stream, so a strategy's choices don't depend on which worker plays the game
+	virtual void startGame(Random) {}
+	virtual void playMove(Board& board) = 0;
+};
+
+//presses a uniformly random covered cell, the baseline any other strategy should beat
+class RandomStrategy : public PlayStrategy
+{
+public:
+	void startGame(Random random) override { randomEngine = random; }
+	void playMove(Board& board) override
+	{
+		coveredCells.clear();
+		for (size_t y = 0; y < board.getHeight(); y++)
+		{
+			for (size_t x = 0; x < board.getWidth(); x++)
+			{
+				if (board.getCells()(x, y).state == Board::CellState::eCovered) coveredCells.emplace_back(x, y);
+			}
+		}
+		auto [x, y] = coveredCells[randomEngine.nextBelow(coveredCells.size())];
+		board.pressCell(static_cast<int64_t>(x), static_cast<int64_t>(y));
+	}
+
+private:
+	Random randomEngine;
+	std::vector<std::pair<size_t, size_t>> coveredCells;
+};
+
+//presses every cell the solver proves safe, or the least likely mine when nothing is certain
+class SolverStrategy : public PlayStrategy
+{
+public:
+	void playMove(Board& board) override
+	{
+		auto input = board.getSolverInput();
+		auto result = solver.solve(input);
+		if (result.safeCells.empty())
+		{
+			std::size_t guess = SIZE_MAX;
+			for (std::size_t cell = 0; cell < input.cells.size(); cell++)
+			{
+				if (input.cells[cell] == SolverInput::COVERED && (guess == SIZE_MAX || result.mineProbabilities[cell] < result.mineProbabilities[guess])) guess = cell;
+			}
+			result.safeCells.push_back(guess);
+		}
+		for (auto cell : result.safeCells)
+		{
+			auto x = static_cast<int64_t>(cell % input.width);
+			auto y = static_cast<int64_t>(cell / input.width);
+			if (board.getCurrentState() == Board::State::eLost) return;
+			if (board.getCellAtIndex(x, y).state == Board::CellState::eCovered) board.pressCell(x, y);
+		}
+	}
+
+private:
+	//one solver per worker, with no threads it has no pool of its own and enumerates on the worker itself
+	Solver solver{ 0 };
+};
+
+struct BatchStatistics
+{
+	uint64_t games = 0;
+	uint64_t wins = 0;
+	uint64_t moves = 0;
+	double bbbvSum = 0.0;
+	double bbbvSquareSum = 0.0;
+	uint64_t bbbvMin = UINT64_MAX;
+	uint64_t bbbvMax = 0;
+	double wonBbbvSum = 0.0;
+	double openingSum = 0.0;
+	double islandSum = 0.0;
+
+	void merge(BatchStatistics const& other)
+	{
+		games += other.games;
+		wins += other.wins;
+		moves += other.moves;
+		bbbvSum += other.bbbvSum;
+		bbbvSquareSum += other.bbbvSquareSum;
+		bbbvMin = std::min(bbbvMin, other.bbbvMin);
+		bbbvMax = std::max(bbbvMax, other.bbbvMax);
+		wonBbbvSum += other.wonBbbvSum;
+		openingSum += other.openingSum;
+		islandSum += other.islandSum;
+	}
+};
+
+static std::unique_ptr<PlayStrategy> makeStrategy(std::string_view name)
+{
+	if (name == "random"sv) return std::make_unique<RandomStrategy>();
+	return std::make_unique<SolverStrategy>();
+}
+
+//games are handed out from a shared counter and every game's random stream comes from its number, so results don't depend on the thread count
+static BatchStatistics runWorker(std::string_view strategyName, std::atomic<uint64_t>& nextGame, uint64_t gameCount, size_t width, size_t height,
+	size_t mineCount)
+{
+	BatchStatistics statistics;
+	auto strategy = makeStrategy(strategyName);
+	Board board(width, height);
+	board.setJournalDepth(0);
+	for (auto game = nextGame.fetch_add(1, std::memory_order_relaxed); game < gameCount; game = nextGame.fetch_add(1, std::memory_order_relaxed))
+	{
+		Random gameRandom(game);
+		auto layout = generateBoardLayout(width, height, mineCount, gameRandom.split());
+		strategy->startGame(gameRandom);
+		auto metrics = analyzeBoard(layout);
+		auto bbbv = metrics.bbbv;
+		board.applyLayout(std::move(layout));
+		while (board.getCurrentState() == Board::State::ePreparing || board.getCurrentState() == Board::State::ePlaying)
+		{
+			strategy->playMove(board);
+			statistics.moves++;
+		}
+
+		bool won = board.getCurrentState() == Board::State::eWon;
+		statistics.games++;
+		statistics.wins += won;
+		statistics.bbbvSum += double(bbbv);
+		statistics.bbbvSquareSum += double(bbbv) * double(bbbv);
+		statistics.bbbvMin = std::min(statistics.bbbvMin, bbbv);
+		statistics.bbbvMax = std::max(statistics.bbbvMax, bbbv);
+		if (won) statistics.wonBbbvSum += double(bbbv);
+		statistics.openingSum += double(metrics.openings);
+		statistics.islandSum += double(metrics.islands);
+	}
+	return statistics;
+}
+
+//plays generated boards headless on every core with a pluggable strategy, for difficulty tuning
+//usage: BatchSimulation [random|solver] [games] [width] [height] [mines] [threads]
+int main(int argc, char** argv)
+{
+	std::string strategyName = argc > 1 ? argv[1] : "solver";
+	uint64_t gameCount = argc > 2 ? std::stoull(argv[2]) : 10000;
+	size_t width = argc > 3 ? std::stoul(argv[3]) : 30;
+	size_t height = argc > 4 ? std::stoul(argv[4]) : 16;
+	size_t mineCount = argc > 5 ? std::stoul(argv[5]) : 99;
+	size_t threadCount = argc > 6 ? std::stoul(argv[6]) : std::thread::hardware_concurrency();
+	threadCount = std::max<size_t>(threadCount, 1);
+
+	std::atomic<uint64_t> nextGame{ 0 };
+	BatchStatistics statistics;
+	auto startTime = std::chrono::steady_clock::now();
+	{
+		ThreadPool threadPool(threadCount);
+		std::vector<std::future<BatchStatistics>> workers;
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			workers.push_back(threadPool.submit([&]() { return runWorker(strategyName, nextGame, gameCount, width, height, mineCount); }));
+		}
+		for (auto& worker : workers) statistics.merge(worker.get());
+	}
+	auto elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	auto games = double(std::max<uint64_t>(statistics.games, 1));
+	auto bbbvMean = statistics.bbbvSum / games;
+	auto bbbvDeviation = std::sqrt(std::max(0.0, statistics.bbbvSquareSum / games - bbbvMean * bbbvMean));
+	std::cout << statistics.games << " " << strategyName << " games of " << width << "x" << height << " with " << mineCount << " mines on " << threadCount
+		<< " threads\n";
+	std::cout << "time " << elapsedTime << " s, " << statistics.games / elapsedTime << " games/s, " << double(statistics.moves) / games << " moves per game\n";
+	std::cout << "won " << statistics.wins << " (" << 100.0 * statistics.wins / games << "%)\n";
+	std::cout << "3BV mean " << bbbvMean << ", deviation " << bbbvDeviation << ", min " << statistics.bbbvMin << ", max " << statistics.bbbvMax
+		<< ", mean of won games " << (statistics.wins > 0 ? statistics.wonBbbvSum / statistics.wins : 0.0) << "\n";
+	std::cout << "openings mean " << statistics.openingSum / games << ", islands mean " << statistics.islandSum / games << "\n";
+	return 0;
+}
\ No newline at end of file
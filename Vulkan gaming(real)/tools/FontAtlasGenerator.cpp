@@ -0,0 +1,102 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include <json.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "DistanceField.h"
+
+using namespace nlohmann;
+using namespace std::literals;
+
+//converts a bitmap font atlas into a single channel signed distance field atlas plus its font info
+//usage: FontAtlasGenerator <font info json> <output name> [downscale] [spread]
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cout << "usage: FontAtlasGenerator <font info json> <output name> [downscale] [spread]\n";
+		return 1;
+	}
+
+	std::filesystem::path fontInfoPath{argv[1]};
+	std::filesystem::path outputPath{argv[2]};
+	uint32_t scale = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 2;
+	float spread = argc > 4 ? std::stof(argv[4]) : 4.0f;
+
+	std::ifstream fontInfoFile{fontInfoPath};
+	if (!fontInfoFile)
+	{
+		std::cerr << "couldn't open font info file: " << fontInfoPath << "\n";
+		return 1;
+	}
+	json fontInfo = json::parse(fontInfoFile, nullptr, false);
+
+	uint32_t cellWidth = fontInfo["cellWidth"];
+	uint32_t cellHeight = fontInfo["cellHeight"];
+	uint32_t charWidth = fontInfo["charWidth"];
+	uint32_t charHeight = fontInfo["charHeight"];
+	if (scale == 0 || cellWidth % scale != 0 || cellHeight % scale != 0)
+	{
+		std::cerr << "cell size must be divisible by the downscale factor\n";
+		return 1;
+	}
+
+	auto bitmapPath = fontInfoPath;
+	bitmapPath.replace_extension(".png");
+	int bitmapWidth{}, bitmapHeight{}, bitmapChannels{};
+	stbi_uc* bitmap = stbi_load(bitmapPath.string().c_str(), &bitmapWidth, &bitmapHeight, &bitmapChannels, STBI_rgb_alpha);
+	if (bitmap == nullptr)
+	{
+		std::cerr << "couldn't load font bitmap: " << bitmapPath << "\n";
+		return 1;
+	}
+
+	uint32_t atlasWidth = static_cast<uint32_t>(bitmapWidth) / scale;
+	uint32_t atlasHeight = static_cast<uint32_t>(bitmapHeight) / scale;
+	uint32_t fieldCellWidth = cellWidth / scale;
+	uint32_t fieldCellHeight = cellHeight / scale;
+	std::vector<uint8_t> atlas(std::size_t(atlasWidth) * atlasHeight, 0);
+
+	for (uint32_t cellY = 0; cellY < static_cast<uint32_t>(bitmapHeight) / cellHeight; cellY++)
+	{
+		for (uint32_t cellX = 0; cellX < static_cast<uint32_t>(bitmapWidth) / cellWidth; cellX++)
+		{
+			auto source = bitmap + (std::size_t(cellY) * cellHeight * bitmapWidth + std::size_t(cellX) * cellWidth) * 4;
+			auto target = atlas.data() + std::size_t(cellY) * fieldCellHeight * atlasWidth + std::size_t(cellX) * fieldCellWidth;
+			generateDistanceField(source, cellWidth, cellHeight, static_cast<uint32_t>(bitmapWidth), 4, target, fieldCellWidth, fieldCellHeight, atlasWidth,
+				scale, spread);
+		}
+	}
+	stbi_image_free(bitmap);
+
+	auto atlasPath = outputPath;
+	atlasPath.replace_extension(".pgm");
+	std::ofstream atlasFile{atlasPath, std::ios::binary};
+	atlasFile << "P5\n" << atlasWidth << " " << atlasHeight << "\n255\n";
+	atlasFile.write(reinterpret_cast<char const*>(atlas.data()), static_cast<std::streamsize>(atlas.size()));
+
+	fontInfo["bitmap"] = atlasPath.filename().string();
+	fontInfo["bitmapWidth"] = atlasWidth;
+	fontInfo["bitmapHeight"] = atlasHeight;
+	fontInfo["cellWidth"] = fieldCellWidth;
+	fontInfo["cellHeight"] = fieldCellHeight;
+	fontInfo["charWidth"] = static_cast<uint32_t>(std::ceil(static_cast<float>(charWidth) / scale));
+	fontInfo["charHeight"] = static_cast<uint32_t>(std::ceil(static_cast<float>(charHeight) / scale));
+	fontInfo["distanceField"] = true;
+	fontInfo["distanceFieldScale"] = scale;
+	fontInfo["distanceFieldSpread"] = spread;
+
+	auto fontInfoOutputPath = outputPath;
+	fontInfoOutputPath.replace_extension(".json");
+	std::ofstream fontInfoOutputFile{fontInfoOutputPath};
+	fontInfoOutputFile << fontInfo.dump(1, '\t');
+
+	std::cout << "Wrote " << atlasWidth << "x" << atlasHeight << " distance field atlas to " << atlasPath << "\n";
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,572 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include <json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace nlohmann;
+using namespace std::literals;
+
+struct Point
+{
+	float x, y;
+};
+
+//glyph outline flattened into closed polygons, in font units with y up
+using Outline = std::vector<std::vector<Point>>;
+
+//the subset of a TrueType font needed to rasterize glyphs: character map, horizontal metrics and quadratic glyf outlines
+//reads outside of the file return 0, so a damaged font draws wrong glyphs instead of reading past the buffer
+class TrueTypeFont
+{
+public:
+	bool load(std::filesystem::path const& path)
+	{
+		std::ifstream file{path, std::ios::binary};
+		if (!file) return false;
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		auto head = findTable("head");
+		auto hhea = findTable("hhea");
+		auto maxp = findTable("maxp");
+		hmtx = findTable("hmtx");
+		loca = findTable("loca");
+		glyf = findTable("glyf");
+		cmap = findCharacterMap();
+		if (!head || !hhea || !maxp || !hmtx || !loca || !glyf || !cmap) return false;
+
+		unitsPerEm = u16(head + 18);
+		longLocaOffsets = i16(head + 50) != 0;
+		horizontalMetricCount = u16(hhea + 34);
+		glyphCount = u16(maxp + 4);
+		return unitsPerEm > 0 && horizontalMetricCount > 0;
+	}
+
+	uint32_t findGlyph(char32_t codepoint) const
+	{
+		if (u16(cmap) == 12)
+		{
+			uint32_t groupCount = u32(cmap + 12);
+			for (uint32_t i = 0; i < groupCount; i++)
+			{
+				std::size_t group = cmap + 16 + std::size_t(i) * 12;
+				if (codepoint >= u32(group) && codepoint <= u32(group + 4)) return u32(group + 8) + (codepoint - u32(group));
+			}
+			return 0;
+		}
+
+		if (codepoint > 0xFFFF) return 0;
+		std::size_t segmentCount = u16(cmap + 6) / 2;
+		std::size_t endCodes = cmap + 14;
+		std::size_t startCodes = endCodes + segmentCount * 2 + 2;
+		std::size_t deltas = startCodes + segmentCount * 2;
+		std::size_t rangeOffsets = deltas + segmentCount * 2;
+		for (std::size_t i = 0; i < segmentCount; i++)
+		{
+			if (codepoint > u16(endCodes + i * 2)) continue;
+			uint16_t start = u16(startCodes + i * 2);
+			if (codepoint < start) return 0;
+
+			uint16_t delta = u16(deltas + i * 2);
+			uint16_t rangeOffset = u16(rangeOffsets + i * 2);
+			if (rangeOffset == 0) return uint16_t(codepoint + delta);
+			uint16_t glyph = u16(rangeOffsets + i * 2 + rangeOffset + (codepoint - start) * 2);
+			return glyph == 0 ? 0 : uint16_t(glyph + delta);
+		}
+		return 0;
+	}
+
+	uint16_t getAdvance(uint32_t glyph) const
+	{
+		return u16(hmtx + std::size_t(std::min<uint32_t>(glyph, horizontalMetricCount - 1)) * 4);
+	}
+
+	Outline getOutline(uint32_t glyph) const
+	{
+		Outline outline;
+		appendOutline(glyph, {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f}, outline, 0);
+		return outline;
+	}
+
+private:
+	//x' = xx * x + yx * y + dx, y' = xy * x + yy * y + dy
+	struct Transform
+	{
+		float xx, xy, yx, yy, dx, dy;
+
+		Point apply(Point point) const { return {xx * point.x + yx * point.y + dx, xy * point.x + yy * point.y + dy}; }
+	};
+
+	static constexpr uint32_t MAX_COMPOSITE_DEPTH = 8;
+	static constexpr uint32_t CURVE_SEGMENTS = 8;
+
+	uint8_t u8(std::size_t offset) const { return offset < data.size() ? data[offset] : 0; }
+	uint16_t u16(std::size_t offset) const { return uint16_t(u8(offset) << 8 | u8(offset + 1)); }
+	int16_t i16(std::size_t offset) const { return static_cast<int16_t>(u16(offset)); }
+	uint32_t u32(std::size_t offset) const { return uint32_t(u16(offset)) << 16 | u16(offset + 2); }
+	float f2dot14(std::size_t offset) const { return i16(offset) / 16384.0f; }
+
+	std::size_t findTable(std::string_view tag) const
+	{
+		uint16_t tableCount = u16(4);
+		for (std::size_t i = 0; i < tableCount; i++)
+		{
+			std::size_t record = 12 + i * 16;
+			if (record + 4 <= data.size() && std::equal(tag.begin(), tag.end(), data.begin() + record)) return u32(record + 8);
+		}
+		return 0;
+	}
+
+	//prefers the full unicode format 12 subtable and falls back to the basic plane format 4 one
+	std::size_t findCharacterMap() const
+	{
+		auto table = findTable("cmap");
+		if (!table) return 0;
+		std::size_t basicPlane = 0;
+		uint16_t subtableCount = u16(table + 2);
+		for (std::size_t i = 0; i < subtableCount; i++)
+		{
+			uint16_t platform = u16(table + 4 + i * 8);
+			uint16_t encoding = u16(table + 6 + i * 8);
+			std::size_t subtable = table + u32(table + 8 + i * 8);
+			bool isUnicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+			if (!isUnicode) continue;
+			if (u16(subtable) == 12) return subtable;
+			if (u16(subtable) == 4) basicPlane = subtable;
+		}
+		return basicPlane;
+	}
+
+	std::pair<std::size_t, std::size_t> getGlyphRange(uint32_t glyph) const
+	{
+		if (glyph >= glyphCount) return {0, 0};
+		if (longLocaOffsets) return {glyf + u32(loca + glyph * 4), glyf + u32(loca + glyph * 4 + 4)};
+		return {glyf + u16(loca + glyph * 2) * 2ULL, glyf + u16(loca + glyph * 2 + 2) * 2ULL};
+	}
+
+	void appendOutline(uint32_t glyph, Transform const& transform, Outline& outline, uint32_t depth) const
+	{
+		auto [begin, end] = getGlyphRange(glyph);
+		if (begin >= end) return;
+
+		int16_t contourCount = i16(begin);
+		if (contourCount >= 0) appendSimpleOutline(begin, static_cast<uint16_t>(contourCount), transform, outline);
+		else if (depth < MAX_COMPOSITE_DEPTH) appendCompositeOutline(begin, transform, outline, depth);
+	}
+
+	void appendSimpleOutline(std::size_t glyph, uint16_t contourCount, Transform const& transform, Outline& outline) const
+	{
+		if (contourCount == 0) return;
+		std::size_t endPoints = glyph + 10;
+		std::size_t pointCount = std::size_t(u16(endPoints + (contourCount - 1) * 2ULL)) + 1;
+		std::size_t cursor = endPoints + contourCount * 2ULL;
+		cursor += 2 + u16(cursor);
+
+		std::vector<uint8_t> flags;
+		flags.reserve(pointCount);
+		while (flags.size() < pointCount && cursor < data.size())
+		{
+			uint8_t flag = u8(cursor++);
+			std::size_t repeat = flag & 8 ? u8(cursor++) + 1ULL : 1;
+			flags.insert(flags.end(), std::min(repeat, pointCount - flags.size()), flag);
+		}
+		flags.resize(pointCount);
+
+		//coordinates are deltas, either one unsigned byte with a sign flag or a signed short unless the same flag says it didn't change
+		auto readCoordinates = [&](uint8_t shortBit, uint8_t sameBit)
+		{
+			std::vector<float> coordinates(pointCount);
+			int32_t value = 0;
+			for (std::size_t i = 0; i < pointCount; i++)
+			{
+				if (flags[i] & shortBit)
+				{
+					value += flags[i] & sameBit ? u8(cursor) : -u8(cursor);
+					cursor++;
+				}
+				else if (!(flags[i] & sameBit))
+				{
+					value += i16(cursor);
+					cursor += 2;
+				}
+				coordinates[i] = static_cast<float>(value);
+			}
+			return coordinates;
+		};
+		auto xs = readCoordinates(2, 16);
+		auto ys = readCoordinates(4, 32);
+
+		std::size_t first = 0;
+		for (uint16_t contour = 0; contour < contourCount; contour++)
+		{
+			std::size_t last = std::min<std::size_t>(u16(endPoints + contour * 2ULL), pointCount - 1);
+			if (last < first) break;
+			std::vector<std::pair<Point, bool>> points;
+			for (std::size_t i = first; i <= last; i++)
+			{
+				points.emplace_back(transform.apply({xs[i], ys[i]}), flags[i] & 1);
+			}
+			outline.push_back(flattenContour(points));
+			first = last + 1;
+		}
+	}
+
+	void appendCompositeOutline(std::size_t glyph, Transform const& transform, Outline& outline, uint32_t depth) const
+	{
+		std::size_t cursor = glyph + 10;
+		uint16_t flags{};
+		do
+		{
+			flags = u16(cursor);
+			uint16_t component = u16(cursor + 2);
+			cursor += 4;
+
+			//matching anchor points instead of offsets is rare enough to place those components at the origin
+			float dx{}, dy{};
+			if (flags & 1)
+			{
+				if (flags & 2) dx = i16(cursor), dy = i16(cursor + 2);
+				cursor += 4;
+			}
+			else
+			{
+				if (flags & 2) dx = static_cast<int8_t>(u8(cursor)), dy = static_cast<int8_t>(u8(cursor + 1));
+				cursor += 2;
+			}
+
+			Transform local{1.0f, 0.0f, 0.0f, 1.0f, dx, dy};
+			if (flags & 8)
+			{
+				local.xx = local.yy = f2dot14(cursor);
+				cursor += 2;
+			}
+			else if (flags & 0x40)
+			{
+				local.xx = f2dot14(cursor);
+				local.yy = f2dot14(cursor + 2);
+				cursor += 4;
+			}
+			else if (flags & 0x80)
+			{
+				local.xx = f2dot14(cursor);
+				local.xy = f2dot14(cursor + 2);
+				local.yx = f2dot14(cursor + 4);
+				local.yy = f2dot14(cursor + 6);
+				cursor += 8;
+			}
+
+			Transform combined{transform.xx * local.xx + transform.yx * local.xy, transform.xy * local.xx + transform.yy * local.xy,
+				transform.xx * local.yx + transform.yx * local.yy, transform.xy * local.yx + transform.yy * local.yy, 0.0f, 0.0f};
+			auto offset = transform.apply({dx, dy});
+			combined.dx = offset.x;
+			combined.dy = offset.y;
+			appendOutline(component, combined, outline, depth + 1);
+		} while (flags & 0x20);
+	}
+
+	//two off curve points in a row imply an on curve point halfway between them
+	static std::vector<Point> flattenContour(std::vector<std::pair<Point, bool>> const& points)
+	{
+		auto midpoint = [](Point a, Point b) { return Point{(a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f}; };
+
+		std::size_t start = 0;
+		while (start < points.size() && !points[start].second) start++;
+		Point begin = start < points.size() ? points[start].first : midpoint(points.front().first, points.back().first);
+
+		std::vector<Point> polygon{begin};
+		Point current = begin;
+		bool hasControl = false;
+		Point control{};
+		auto curveTo = [&](Point target)
+		{
+			for (uint32_t i = 1; i <= CURVE_SEGMENTS; i++)
+			{
+				float t = static_cast<float>(i) / CURVE_SEGMENTS;
+				float u = 1.0f - t;
+				polygon.push_back({u * u * current.x + 2 * u * t * control.x + t * t * target.x, u * u * current.y + 2 * u * t * control.y + t * t * target.y});
+			}
+		};
+		for (std::size_t i = 1; i <= points.size(); i++)
+		{
+			auto [point, onCurve] = start < points.size() ? points[(start + i) % points.size()] : points[(i - 1) % points.size()];
+			if (onCurve)
+			{
+				if (hasControl) curveTo(point);
+				else polygon.push_back(point);
+				current = point;
+				hasControl = false;
+			}
+			else
+			{
+				if (hasControl)
+				{
+					auto implied = midpoint(control, point);
+					curveTo(implied);
+					current = implied;
+				}
+				control = point;
+				hasControl = true;
+			}
+		}
+		if (hasControl) curveTo(begin);
+		return polygon;
+	}
+
+	std::vector<uint8_t> data;
+	uint16_t unitsPerEm{};
+	std::size_t hmtx{};
+	std::size_t loca{};
+	std::size_t glyf{};
+	std::size_t cmap{};
+	bool longLocaOffsets{};
+	uint16_t horizontalMetricCount{};
+	uint16_t glyphCount{};
+};
+
+//nonzero winding coverage of the outline, already in pixel space with y down, sampled on SUBSCANLINES rows per pixel with exact horizontal coverage
+static std::vector<float> rasterizeOutline(Outline const& outline, uint32_t width, uint32_t height)
+{
+	static constexpr uint32_t SUBSCANLINES = 5;
+
+	std::vector<float> coverage(std::size_t(width) * height, 0.0f);
+	std::vector<std::pair<float, int>> crossings;
+	for (uint32_t row = 0; row < height * SUBSCANLINES; row++)
+	{
+		float y = (row + 0.5f) / SUBSCANLINES;
+		crossings.clear();
+		for (auto const& polygon : outline)
+		{
+			for (std::size_t i = 0; i < polygon.size(); i++)
+			{
+				auto a = polygon[i];
+				auto b = polygon[(i + 1) % polygon.size()];
+				if (a.y == b.y || y < std::min(a.y, b.y) || y >= std::max(a.y, b.y)) continue;
+				crossings.emplace_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y), b.y > a.y ? 1 : -1);
+			}
+		}
+		std::sort(crossings.begin(), crossings.end());
+
+		auto target = coverage.data() + std::size_t(row / SUBSCANLINES) * width;
+		int winding = 0;
+		for (std::size_t i = 0; i + 1 < crossings.size(); i++)
+		{
+			winding += crossings[i].second;
+			if (winding == 0) continue;
+			float spanBegin = std::clamp(crossings[i].first, 0.0f, static_cast<float>(width));
+			float spanEnd = std::clamp(crossings[i + 1].first, 0.0f, static_cast<float>(width));
+			for (auto x = static_cast<uint32_t>(spanBegin); x < width && x < spanEnd; x++)
+			{
+				target[x] += (std::min(spanEnd, x + 1.0f) - std::max(spanBegin, static_cast<float>(x))) / SUBSCANLINES;
+			}
+		}
+	}
+	return coverage;
+}
+
+static uint32_t crc32(uint8_t const* bytes, std::size_t size, uint32_t crc)
+{
+	static auto const table = []
+	{
+		std::array<uint32_t, 256> values{};
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; bit++) value = value & 1 ? 0xEDB88320U ^ (value >> 1) : value >> 1;
+			values[i] = value;
+		}
+		return values;
+	}();
+
+	crc = ~crc;
+	for (std::size_t i = 0; i < size; i++) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+//RGBA png with the image data in stored deflate blocks, glyphs are small enough that compressing them isn't worth a dependency
+static bool writePng(std::filesystem::path const& path, uint32_t width, uint32_t height, std::vector<uint8_t> const& pixels)
+{
+	std::vector<uint8_t> scanlines;
+	for (uint32_t y = 0; y < height; y++)
+	{
+		scanlines.push_back(0);
+		scanlines.insert(scanlines.end(), pixels.begin() + std::size_t(y) * width * 4, pixels.begin() + std::size_t(y + 1) * width * 4);
+	}
+
+	auto appendBigEndian = [](std::vector<uint8_t>& target, uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8) target.push_back(static_cast<uint8_t>(value >> shift));
+	};
+
+	std::vector<uint8_t> compressed{0x78, 0x01};
+	uint32_t adlerLow = 1, adlerHigh = 0;
+	for (std::size_t offset = 0; offset < scanlines.size(); offset += 0xFFFF)
+	{
+		auto blockSize = static_cast<uint16_t>(std::min<std::size_t>(scanlines.size() - offset, 0xFFFF));
+		compressed.push_back(offset + blockSize == scanlines.size() ? 1 : 0);
+		compressed.insert(compressed.end(), {uint8_t(blockSize), uint8_t(blockSize >> 8), uint8_t(~blockSize), uint8_t(~blockSize >> 8)});
+		compressed.insert(compressed.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+	}
+	for (auto byte : scanlines)
+	{
+		adlerLow = (adlerLow + byte) % 65521;
+		adlerHigh = (adlerHigh + adlerLow) % 65521;
+	}
+	appendBigEndian(compressed, adlerHigh << 16 | adlerLow);
+
+	std::vector<uint8_t> header;
+	appendBigEndian(header, width);
+	appendBigEndian(header, height);
+	header.insert(header.end(), {8, 6, 0, 0, 0});
+
+	std::ofstream file{path, std::ios::binary};
+	file.write("\x89PNG\r\n\x1A\n", 8);
+	auto writeChunk = [&](char const* type, std::vector<uint8_t> const& chunk)
+	{
+		std::vector<uint8_t> framed;
+		appendBigEndian(framed, static_cast<uint32_t>(chunk.size()));
+		framed.insert(framed.end(), type, type + 4);
+		framed.insert(framed.end(), chunk.begin(), chunk.end());
+		appendBigEndian(framed, crc32(framed.data() + 4, chunk.size() + 4, 0));
+		file.write(reinterpret_cast<char const*>(framed.data()), static_cast<std::streamsize>(framed.size()));
+	};
+	writeChunk("IHDR", header);
+	writeChunk("IDAT", compressed);
+	writeChunk("IEND", {});
+	return bool(file);
+}
+
+//renders glyphs outside of latin-1 from a TrueType font into the glyphs directory next to the font's atlas, where GlyphCache loads them on demand
+//the baseline and cap height are measured from the atlas' H, so the generated glyphs line up with the atlas ones, wider glyphs are shrunk to fit the cell
+//distance field fonts share the directory and are downscaled when loaded, so generate from the full resolution font info
+//usage: GlyphGenerator <font info json> <truetype font> <first codepoint>[-<last codepoint>]...
+int main(int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		std::cout << "usage: GlyphGenerator <font info json> <truetype font> <first codepoint>[-<last codepoint>]...\n";
+		return 1;
+	}
+
+	std::filesystem::path fontInfoPath{argv[1]};
+	std::ifstream fontInfoFile{fontInfoPath};
+	if (!fontInfoFile)
+	{
+		std::cerr << "couldn't open font info file: " << fontInfoPath << "\n";
+		return 1;
+	}
+	json fontInfo = json::parse(fontInfoFile, nullptr, false);
+	if (fontInfo.value("distanceField", false))
+	{
+		std::cerr << "generate glyphs from the full resolution font info, distance field fonts convert them when loading\n";
+		return 1;
+	}
+	uint32_t cellWidth = fontInfo["cellWidth"];
+	uint32_t cellHeight = fontInfo["cellHeight"];
+	uint32_t startChar = fontInfo["startChar"];
+
+	auto bitmapPath = fontInfoPath;
+	bitmapPath.replace_extension(".png");
+	if (fontInfo.contains("bitmap")) bitmapPath.replace_filename(fontInfo["bitmap"].get<std::string>());
+	int bitmapWidth{}, bitmapHeight{}, bitmapChannels{};
+	stbi_uc* bitmap = stbi_load(bitmapPath.string().c_str(), &bitmapWidth, &bitmapHeight, &bitmapChannels, STBI_rgb_alpha);
+	if (bitmap == nullptr)
+	{
+		std::cerr << "couldn't load font bitmap: " << bitmapPath << "\n";
+		return 1;
+	}
+	uint32_t referenceCell = 'H' - startChar;
+	uint32_t referenceX = referenceCell % (static_cast<uint32_t>(bitmapWidth) / cellWidth) * cellWidth;
+	uint32_t referenceY = referenceCell / (static_cast<uint32_t>(bitmapWidth) / cellWidth) * cellHeight;
+	uint32_t capTop = cellHeight, baseline = 0;
+	for (uint32_t y = 0; y < cellHeight && referenceY + y < static_cast<uint32_t>(bitmapHeight); y++)
+	{
+		for (uint32_t x = 0; x < cellWidth; x++)
+		{
+			if (bitmap[((std::size_t(referenceY) + y) * bitmapWidth + referenceX + x) * 4 + 3] < 128) continue;
+			capTop = std::min(capTop, y);
+			baseline = y + 1;
+		}
+	}
+	stbi_image_free(bitmap);
+	if (baseline <= capTop)
+	{
+		std::cerr << "the atlas has no H to measure the baseline from\n";
+		return 1;
+	}
+
+	TrueTypeFont font;
+	if (!font.load(argv[2]))
+	{
+		std::cerr << "couldn't load TrueType font, only glyf outlines are supported: " << argv[2] << "\n";
+		return 1;
+	}
+
+	auto glyphDirectory = fontInfoPath.parent_path() / "glyphs";
+	std::filesystem::create_directories(glyphDirectory);
+
+	float capHeight = 0.0f;
+	for (auto const& polygon : font.getOutline(font.findGlyph('H')))
+	{
+		for (auto point : polygon) capHeight = std::max(capHeight, point.y);
+	}
+	if (capHeight <= 0.0f)
+	{
+		std::cerr << "the font has no H to measure the cap height from\n";
+		return 1;
+	}
+	float fontScale = (baseline - capTop) / capHeight;
+	uint32_t written = 0, missing = 0;
+	for (int i = 3; i < argc; i++)
+	{
+		std::string range{argv[i]};
+		auto separator = range.find('-');
+		auto first = static_cast<char32_t>(std::stoul(range.substr(0, separator), nullptr, 0));
+		auto last = separator == std::string::npos ? first : static_cast<char32_t>(std::stoul(range.substr(separator + 1), nullptr, 0));
+
+		//latin-1 is always drawn from the atlas
+		for (char32_t codepoint = std::max<char32_t>(first, 0x100); codepoint <= last; codepoint++)
+		{
+			auto glyph = font.findGlyph(codepoint);
+			if (glyph == 0)
+			{
+				missing++;
+				continue;
+			}
+
+			float scale = fontScale;
+			if (font.getAdvance(glyph) * scale > cellWidth) scale = static_cast<float>(cellWidth) / font.getAdvance(glyph);
+			auto outline = font.getOutline(glyph);
+			for (auto& polygon : outline)
+			{
+				for (auto& point : polygon) point = {point.x * scale, baseline - point.y * scale};
+			}
+
+			auto coverage = rasterizeOutline(outline, cellWidth, cellHeight);
+			std::vector<uint8_t> pixels(coverage.size() * 4, 255);
+			for (std::size_t pixel = 0; pixel < coverage.size(); pixel++)
+			{
+				pixels[pixel * 4 + 3] = static_cast<uint8_t>(std::clamp(coverage[pixel], 0.0f, 1.0f) * 255.0f + 0.5f);
+			}
+
+			auto filename = glyphDirectory / std::format("U+{:04X}.png"sv, static_cast<uint32_t>(codepoint));
+			if (!writePng(filename, cellWidth, cellHeight, pixels))
+			{
+				std::cerr << "couldn't write " << filename << "\n";
+				return 1;
+			}
+			written++;
+		}
+	}
+
+	std::cout << "Wrote " << written << " glyphs to " << glyphDirectory << ", " << missing << " codepoints aren't in the font\n";
+	return 0;
+}
\ No newline at end of file
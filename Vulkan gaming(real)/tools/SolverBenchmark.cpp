@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BoardGenerator.h"
+#include "Solver.h"
+
+struct BoardStatistics
+{
+	bool won = false;
+	uint64_t solveCount = 0;
+	uint64_t guessCount = 0;
+};
+
+//plays one board the way auto-play does, opening on a zero and guessing the least likely mine whenever nothing is certain
+static BoardStatistics playBoard(BoardLayout const& layout, std::size_t width, std::size_t height, Solver& solver)
+{
+	BoardStatistics statistics;
+	SolverInput input{width, height, std::vector<int8_t>(width * height, SolverInput::COVERED), layout.mineCount};
+	auto safeCellCount = width * height - layout.mineCount;
+
+	std::size_t revealedCount = 0;
+	for (std::size_t i = 0; i < width * height && revealedCount == 0; i++)
+	{
+		auto const& cell = layout.cells(i % width, i / width);
+		if (!cell.mined && cell.adjacentMines == 0) revealedCount = revealLayoutCells(layout, input, i % width, i / width);
+	}
+
+	while (revealedCount < safeCellCount)
+	{
+		auto result = solver.solve(input);
+		statistics.solveCount++;
+
+		if (result.safeCells.empty())
+		{
+			std::size_t guess = SIZE_MAX;
+			for (std::size_t i = 0; i < input.cells.size(); i++)
+			{
+				if (input.cells[i] < 0 && (guess == SIZE_MAX || result.mineProbabilities[i] < result.mineProbabilities[guess])) guess = i;
+			}
+			statistics.guessCount++;
+			if (layout.cells(guess % width, guess / width).mined) return statistics;
+			result.safeCells.push_back(guess);
+		}
+		for (auto cell : result.safeCells)
+		{
+			revealedCount += revealLayoutCells(layout, input, cell % width, cell / width);
+		}
+	}
+	statistics.won = true;
+	return statistics;
+}
+
+//measures how long no-guess generation takes per board and prints the latency percentiles
+static int benchmarkNoGuessGeneration(std::size_t boardCount, std::size_t width, std::size_t height, std::size_t mineCount, std::size_t threadCount)
+{
+	std::vector<double> latencies;
+	uint64_t noGuessCount = 0;
+	for (std::size_t board = 0; board < boardCount; board++)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		auto layout = generateNoGuessLayout(width, height, mineCount, Random(board + 1), { width / 2, height / 2 }, {}, threadCount);
+		latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+		noGuessCount += layout.noGuess;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double fraction) { return latencies[std::min(static_cast<std::size_t>(fraction * latencies.size()), latencies.size() - 1)]; };
+
+	std::cout << boardCount << " no-guess boards of " << width << "x" << height << " with " << mineCount << " mines on " << threadCount << " threads\n";
+	std::cout << "latency ms p50 " << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99) << ", max " << latencies.back() << "\n";
+	std::cout << "no-guess " << noGuessCount << " (" << 100.0 * noGuessCount / boardCount << "%), the rest gave up after " << NO_GUESS_MAX_TRIALS
+		<< " trials\n";
+	return 0;
+}
+
+//measures solver throughput by playing generated boards to the end, or no-guess generation latency with --no-guess
+//usage: SolverBenchmark [--no-guess] [boards] [width] [height] [mines] [threads]
+int main(int argc, char** argv)
+{
+	bool noGuess = argc > 1 && argv[1] == "--no-guess"sv;
+	if (noGuess)
+	{
+		argc--;
+		argv++;
+	}
+	std::size_t boardCount = argc > 1 ? std::stoul(argv[1]) : 200;
+	std::size_t width = argc > 2 ? std::stoul(argv[2]) : 30;
+	std::size_t height = argc > 3 ? std::stoul(argv[3]) : 16;
+	std::size_t mineCount = argc > 4 ? std::stoul(argv[4]) : 99;
+	std::size_t threadCount = argc > 5 ? std::stoul(argv[5]) : std::thread::hardware_concurrency();
+
+	if (noGuess) return benchmarkNoGuessGeneration(boardCount, width, height, mineCount, threadCount);
+
+	Solver solver(threadCount);
+	uint64_t wins = 0, solveCount = 0, guessCount = 0;
+	auto startTime = std::chrono::steady_clock::now();
+	for (std::size_t board = 0; board < boardCount; board++)
+	{
+		auto layout = generateBoardLayout(width, height, mineCount, Random(board + 1));
+		auto statistics = playBoard(layout, width, height, solver);
+		wins += statistics.won;
+		solveCount += statistics.solveCount;
+		guessCount += statistics.guessCount;
+	}
+	auto elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::cout << boardCount << " boards of " << width << "x" << height << " with " << mineCount << " mines on " << threadCount << " threads\n";
+	std::cout << "time " << elapsedTime << " s, " << boardCount / elapsedTime << " boards/s, " << solveCount / elapsedTime << " solves/s\n";
+	std::cout << "won " << wins << " (" << 100.0 * wins / boardCount << "%), " << double(guessCount) / boardCount << " guesses per board, "
+		<< solver.getCacheHits() << " memoised components\n";
+	return 0;
+}
\ No newline at end of file